@@ -0,0 +1,120 @@
+#define _DEFAULT_SOURCE
+#include "arenaADT.h"
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#define ARENA_ALIGN 16                                                /**< @def Alineacion de cada porcion entregada */
+#define ALIGN_UP(N,A) (((N) + ((A) - 1)) & ~((size_t)(A) - 1))      /**< @def Redondea N al multiplo de A siguiente */
+
+/**
+ * @brief Encabezado de cada bloque reservado. Los bloques forman una lista para poder liberarlos al final.
+ */
+typedef struct chunk {
+    struct chunk * next;      /**< Bloque reservado anteriormente                    */
+    size_t size;              /**< Tamaño total del bloque (incluyendo encabezado)   */
+} TChunk;
+
+/**
+ * @brief TAD reservador de memoria por bloques.
+ */
+typedef struct arenaCDT {
+    TChunk * chunks;          /**< Lista de bloques reservados (el primero es el actual)  */
+    char * current;           /**< Proxima posicion libre del bloque actual              */
+    char * end;               /**< Fin del bloque actual                                 */
+    size_t chunkSize;         /**< Tamaño de cada bloque                                 */
+    size_t reserved;          /**< Bytes reservados al sistema operativo                 */
+    size_t used;              /**< Bytes entregados por arenaAlloc                       */
+    size_t allocations;       /**< Cantidad de pedidos atendidos por arenaAlloc          */
+} arenaCDT;
+
+arenaADT newArenaADT(size_t chunkSize)
+{
+    arenaADT new = calloc(1, sizeof(arenaCDT));
+    if (new == NULL)
+        return NULL;
+    new->chunkSize = chunkSize == 0 ? ARENA_DEFAULT_CHUNK : chunkSize;
+    return new;
+}
+
+/**
+ * @brief Funcion auxiliar que reserva un nuevo bloque mediante mmap. Las paginas anonimas ya vienen en cero,
+ * por lo que no es necesario inicializarlas.
+ *
+ * @param size Tamaño total del bloque.
+ * @return Puntero al bloque o NULL si no se pudo reservar.
+ */
+static TChunk * newChunk(const size_t size)
+{
+    void * mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+        return NULL;
+    TChunk * chunk = mem;
+    chunk->size = size;
+    return chunk;
+}
+
+void * arenaAlloc(arenaADT arena, size_t bytes)
+{
+    bytes = ALIGN_UP(bytes == 0 ? 1 : bytes, ARENA_ALIGN);
+    size_t header = ALIGN_UP(sizeof(TChunk), ARENA_ALIGN);
+
+    if ((size_t)(arena->end - arena->current) < bytes) {
+        /// Los pedidos mas grandes que un bloque reciben un bloque propio, sin descartar el bloque actual.
+        if (bytes + header > arena->chunkSize) {
+            TChunk * big = newChunk(bytes + header);
+            if (big == NULL)
+                return NULL;
+            if (arena->chunks == NULL) {
+                big->next = NULL;
+                arena->chunks = big;
+            } else {
+                big->next = arena->chunks->next;
+                arena->chunks->next = big;
+            }
+            arena->reserved += big->size;
+            arena->used += bytes;
+            arena->allocations++;
+            return (char *)big + header;
+        }
+        TChunk * chunk = newChunk(arena->chunkSize);
+        if (chunk == NULL)
+            return NULL;
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        arena->current = (char *)chunk + header;
+        arena->end = (char *)chunk + chunk->size;
+        arena->reserved += chunk->size;
+    }
+
+    void * out = arena->current;
+    arena->current += bytes;
+    arena->used += bytes;
+    arena->allocations++;
+    return out;
+}
+
+size_t arenaReserved(const arenaADT arena)
+{
+    return arena->reserved;
+}
+
+size_t arenaUsed(const arenaADT arena)
+{
+    return arena->used;
+}
+
+size_t arenaAllocations(const arenaADT arena)
+{
+    return arena->allocations;
+}
+
+void freeArenaADT(arenaADT arena)
+{
+    TChunk * chunk = arena->chunks;
+    while (chunk != NULL) {
+        TChunk * next = chunk->next;
+        munmap(chunk, chunk->size);
+        chunk = next;
+    }
+    free(arena);
+}
@@ -0,0 +1,65 @@
+#ifndef TPEFINAL_ARENAADT_H
+#define TPEFINAL_ARENAADT_H
+
+#include <stdlib.h>
+
+/**
+ * @brief Tamaño por defecto de cada bloque (chunk) reservado por el arena.
+ * @details El usuario podra indicar otro tamaño al crear el arena dependiendo de la magnitud del dataset.
+ */
+#define ARENA_DEFAULT_CHUNK (4 * 1024 * 1024)
+
+typedef struct arenaCDT * arenaADT;
+
+/**
+ * @brief Funcion que crea un nuevo arena: un reservador de memoria que entrega porciones de grandes bloques
+ * contiguos avanzando un puntero, sin liberar porciones individuales.
+ *
+ * @param chunkSize Tamaño en bytes de cada bloque. Si es 0 se utiliza ARENA_DEFAULT_CHUNK.
+ * @return arenaADT creado o NULL si no se pudo reservar memoria.
+ */
+arenaADT newArenaADT(size_t chunkSize);
+
+/**
+ * @brief Funcion que reserva una porcion de memoria dentro del arena.
+ *
+ * @details La memoria devuelta esta inicializada en cero y alineada para cualquier tipo basico. Si el pedido no
+ * entra en el bloque actual se reserva un bloque nuevo (o uno a medida si el pedido supera el tamaño de bloque).
+ * La memoria solo se libera al ejecutar freeArenaADT().
+ *
+ * @param arena Arena del cual se toma la memoria.
+ * @param bytes Cantidad de bytes pedidos.
+ * @return Puntero a la memoria reservada.
+ * @return NULL si se produjo un error de memoria.
+ */
+void * arenaAlloc(arenaADT arena, size_t bytes);
+
+/**
+ * @brief Funcion que devuelve la cantidad de bytes reservados al sistema operativo por el arena.
+ *
+ * @param arena Arena a consultar.
+ */
+size_t arenaReserved(const arenaADT arena);
+
+/**
+ * @brief Funcion que devuelve la cantidad de bytes efectivamente entregados por arenaAlloc() (incluyendo alineacion).
+ *
+ * @param arena Arena a consultar.
+ */
+size_t arenaUsed(const arenaADT arena);
+
+/**
+ * @brief Funcion que devuelve la cantidad de pedidos atendidos por arenaAlloc().
+ *
+ * @param arena Arena a consultar.
+ */
+size_t arenaAllocations(const arenaADT arena);
+
+/**
+ * @brief Funcion que libera todos los bloques reservados por el arena y el arena mismo.
+ *
+ * @param arena Arena a liberar.
+ */
+void freeArenaADT(arenaADT arena);
+
+#endif //TPEFINAL_ARENAADT_H
@@ -0,0 +1,288 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file benchGenerator.c
+ * @brief Generador deterministico de archivos .csv con la forma de los datos de iMDb, para los benchmarks.
+ *
+ * @details Escribe el encabezado y las filas separadas por ";" en el orden que espera la carga (titleType,
+ * primaryTitle, startYear, endYear, genres, averageRating, numVotes, runtimeMinutes). Con la misma semilla y las
+ * mismas opciones el archivo es identico byte a byte. La forma imita a iMDb: mas contenidos en los años recientes,
+ * algunos generos mucho mas frecuentes que otros, votos con cola larga, campos "\N" y tipos de contenido que la
+ * carga descarta.
+ *
+ * Uso: benchGenerator [--rows=N] [--seed=S] [--from=AÑO] [--to=AÑO] [--genres=G] [--title=MIN-MAX] [archivo.csv]
+ */
+
+#define DEFAULT_ROWS 1000000  /**< @def Cantidad de filas por defecto                                    */
+#define DEFAULT_FROM 1874     /**< @def Año de comienzo minimo por defecto                               */
+#define DEFAULT_TO 2025       /**< @def Año de comienzo maximo por defecto                               */
+#define DEFAULT_TITLE_MIN 4   /**< @def Longitud minima de titulo por defecto                            */
+#define DEFAULT_TITLE_MAX 40  /**< @def Longitud maxima de titulo por defecto                            */
+#define MAX_TITLE 250         /**< @def Longitud maxima de titulo admitida (entra en MAX_TITLE_SIZE)     */
+#define MAX_ROW_GENRES 3      /**< @def Cantidad maxima de generos por fila (como en iMDb)               */
+
+#define INVALID_ARGS (-2)     /**< @def Codigo definido para indicar error en los argumentos del programa */
+
+/**
+ * @brief Generos de iMDb. Si se piden mas generos, los siguientes se llaman "Genre<N>".
+ */
+static const char * imdbGenres[] = {
+    "Drama", "Comedy", "Documentary", "Romance", "Action", "Thriller", "Crime", "Horror", "Adventure", "Family",
+    "Animation", "Mystery", "Fantasy", "Biography", "Music", "History", "Sci-Fi", "Musical", "War", "Western",
+    "Sport", "Reality-TV", "Talk-Show", "News", "Game-Show", "Adult", "Film-Noir", "Short"
+};
+
+#define IMDB_GENRES (sizeof(imdbGenres) / sizeof(imdbGenres[0]))
+
+/**
+ * @brief Tipos de contenido con su frecuencia aproximada en iMDb (en porcentaje). Solo "movie" y "tvSeries" se cargan.
+ */
+static const struct { const char * name; unsigned int weight; } titleTypes[] = {
+    { "movie", 55 }, { "tvSeries", 25 }, { "tvMiniSeries", 5 }, { "short", 8 }, { "tvEpisode", 4 }, { "video", 3 }
+};
+
+#define TITLE_TYPES (sizeof(titleTypes) / sizeof(titleTypes[0]))
+
+static const char * syllables[] = {
+    "ka", "lo", "ma", "ri", "the", "an", "de", "la", "mor", "sun", "dark", "ni", "ght", "o", "ver", "sto", "ry",
+    "el", "in", "to", "be", "ra", "tu", "ne", "s", "ion", "lif", "e", "wa", "r"
+};
+
+#define SYLLABLES (sizeof(syllables) / sizeof(syllables[0]))
+
+/**
+ * @brief Opciones del generador.
+ */
+typedef struct genOptions {
+    unsigned long rows;               /**< Cantidad de filas                       */
+    unsigned long seed;               /**< Semilla del generador pseudoaleatorio   */
+    unsigned int from;                /**< Año de comienzo minimo                  */
+    unsigned int to;                  /**< Año de comienzo maximo                  */
+    unsigned int genres;              /**< Cantidad de generos distintos           */
+    unsigned int titleMin;            /**< Longitud minima de los titulos          */
+    unsigned int titleMax;            /**< Longitud maxima de los titulos          */
+    const char * outPath;             /**< Archivo destino (NULL para stdout)      */
+} TGenOptions;
+
+/**
+ * @brief Funcion auxiliar que devuelve el siguiente numero pseudoaleatorio (xorshift64*), igual en toda plataforma.
+ */
+static unsigned long long nextRandom(unsigned long long * state){
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ULL;
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve un numero pseudoaleatorio en [0, 1).
+ */
+static double nextUnit(unsigned long long * state){
+    return (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve un numero pseudoaleatorio en [0, n).
+ */
+static unsigned long nextBelow(unsigned long long * state, const unsigned long n){
+    return (unsigned long)(nextUnit(state) * n);
+}
+
+/**
+ * @brief Funcion auxiliar que escribe un titulo formado por silabas, de longitud entre titleMin y titleMax.
+ */
+static void writeTitle(FILE * out, unsigned long long * state, const TGenOptions * options){
+    char title[MAX_TITLE + 1];
+    size_t len = options->titleMin + nextBelow(state, options->titleMax - options->titleMin + 1);
+    size_t pos = 0;
+    int wordStart = 1;
+    while (pos < len){
+        /// Las palabras tienen entre 1 y 4 silabas; la primera letra de cada palabra va en mayuscula.
+        if (!wordStart && nextBelow(state, 3) == 0 && pos + 1 < len){
+            title[pos++] = ' ';
+            wordStart = 1;
+            continue;
+        }
+        const char * syllable = syllables[nextBelow(state, SYLLABLES)];
+        for (size_t i = 0; syllable[i] != '\0' && pos < len; i++, wordStart = 0)
+            title[pos++] = wordStart ? syllable[i] - 'a' + 'A' : syllable[i];
+    }
+    /// Un titulo no puede terminar en espacio, ya que la carga no lo conservaria igual.
+    title[len - 1] = title[len - 1] == ' ' ? 'x' : title[len - 1];
+    title[len] = '\0';
+    fputs(title, out);
+}
+
+/**
+ * @brief Funcion auxiliar que escribe el nombre de un genero.
+ */
+static void writeGenre(FILE * out, const unsigned int genre){
+    if (genre < IMDB_GENRES)
+        fputs(imdbGenres[genre], out);
+    else
+        fprintf(out, "Genre%u", genre);
+}
+
+/**
+ * @brief Funcion auxiliar que escribe entre 1 y MAX_ROW_GENRES generos distintos, o "\N" (un 4% de las filas). Los
+ * generos con menor numero son mas frecuentes.
+ */
+static void writeGenres(FILE * out, unsigned long long * state, const TGenOptions * options){
+    if (nextBelow(state, 100) < 4){
+        fputs("\\N", out);
+        return;
+    }
+    unsigned int chosen[MAX_ROW_GENRES];
+    size_t count = 1 + nextBelow(state, MAX_ROW_GENRES);
+    if (count > options->genres)
+        count = options->genres;
+    for (size_t i = 0; i < count; i++){
+        unsigned int genre;
+        int repeated;
+        do {
+            double u = nextUnit(state);
+            genre = (unsigned int)(u * u * options->genres);
+            repeated = 0;
+            for (size_t j = 0; j < i; j++)
+                repeated |= chosen[j] == genre;
+        } while (repeated);
+        chosen[i] = genre;
+        if (i > 0)
+            fputc(',', out);
+        writeGenre(out, genre);
+    }
+}
+
+/**
+ * @brief Funcion auxiliar que escribe una fila completa.
+ */
+static void writeRow(FILE * out, unsigned long long * state, const TGenOptions * options){
+    /// Tipo de contenido segun su frecuencia.
+    unsigned long pick = nextBelow(state, 100);
+    size_t type = 0;
+    while (type + 1 < TITLE_TYPES && pick >= titleTypes[type].weight)
+        pick -= titleTypes[type++].weight;
+    int series = strcmp(titleTypes[type].name, "tvSeries") == 0 || strcmp(titleTypes[type].name, "tvMiniSeries") == 0;
+    fputs(titleTypes[type].name, out);
+    fputc(';', out);
+
+    writeTitle(out, state, options);
+
+    /// La densidad de contenidos crece linealmente hacia los años recientes. Un 1% no tiene año.
+    unsigned int year = options->from + (unsigned int)((options->to - options->from + 1) * (1 - nextUnit(state) * nextUnit(state)));
+    if (year > options->to)
+        year = options->to;
+    if (nextBelow(state, 100) == 0)
+        fputs(";\\N", out);
+    else
+        fprintf(out, ";%u", year);
+
+    /// Año de finalizacion: solo la mitad de las series terminaron.
+    if (series && nextBelow(state, 2) == 0){
+        unsigned int end = year + nextBelow(state, 15);
+        fprintf(out, ";%u;", end > options->to ? options->to : end);
+    }
+    else
+        fputs(";\\N;", out);
+
+    writeGenres(out, state, options);
+
+    /// Puntaje: la suma de tres uniformes se concentra alrededor de 6.5. Un 10% no tiene puntaje.
+    if (nextBelow(state, 10) == 0)
+        fputs(";\\N", out);
+    else {
+        unsigned long rating = 10 + (nextBelow(state, 31) + nextBelow(state, 31) + nextBelow(state, 30));
+        fprintf(out, ";%lu.%lu", rating / 10, rating % 10);
+    }
+
+    /// Votos con cola larga (Pareto): la mayoria tiene pocos votos y unos pocos tienen millones.
+    unsigned long votes = nextBelow(state, 10) == 0 ? 0 : (unsigned long)(5 / (1e-7 + (1 - nextUnit(state)) * 0.9999999));
+    double scale = nextUnit(state);
+    votes = (unsigned long)(votes * (scale * scale * scale * 100 + 1));
+    fprintf(out, ";%lu", votes > 3000000 ? 3000000 : votes);
+
+    /// Duracion: peliculas entre 60 y 180 minutos, series entre 20 y 60. Un 15% no tiene duracion.
+    if (nextBelow(state, 100) < 15)
+        fputs(";\\N\n", out);
+    else
+        fprintf(out, ";%lu\n", series ? 20 + nextBelow(state, 41) : 60 + nextBelow(state, 121));
+}
+
+/**
+ * @brief Funcion auxiliar que lee las opciones de la linea de comandos.
+ *
+ * @return 1 si las opciones son validas o INVALID_ARGS si no lo son.
+ */
+static int parseOptions(int argc, char * argv[], TGenOptions * options){
+    options->rows = DEFAULT_ROWS;
+    options->seed = 1;
+    options->from = DEFAULT_FROM;
+    options->to = DEFAULT_TO;
+    options->genres = IMDB_GENRES;
+    options->titleMin = DEFAULT_TITLE_MIN;
+    options->titleMax = DEFAULT_TITLE_MAX;
+    options->outPath = NULL;
+    for (int i = 1; i < argc; i++){
+        char * end = NULL;
+        if (strncmp(argv[i], "--rows=", 7) == 0)
+            options->rows = strtoul(argv[i] + 7, &end, 10);
+        else if (strncmp(argv[i], "--seed=", 7) == 0)
+            options->seed = strtoul(argv[i] + 7, &end, 10);
+        else if (strncmp(argv[i], "--from=", 7) == 0)
+            options->from = strtoul(argv[i] + 7, &end, 10);
+        else if (strncmp(argv[i], "--to=", 5) == 0)
+            options->to = strtoul(argv[i] + 5, &end, 10);
+        else if (strncmp(argv[i], "--genres=", 9) == 0)
+            options->genres = strtoul(argv[i] + 9, &end, 10);
+        else if (strncmp(argv[i], "--title=", 8) == 0){
+            options->titleMin = strtoul(argv[i] + 8, &end, 10);
+            if (*end != '-')
+                return INVALID_ARGS;
+            options->titleMax = strtoul(end + 1, &end, 10);
+        }
+        else if (argv[i][0] != '-' && options->outPath == NULL)
+            options->outPath = argv[i];
+        else
+            return INVALID_ARGS;
+        if (end != NULL && *end != '\0')
+            return INVALID_ARGS;
+    }
+    if (options->from < 1 || options->from > options->to || options->to > 9999 || options->genres < 1 ||
+        options->titleMin < 1 || options->titleMin > options->titleMax || options->titleMax > MAX_TITLE)
+        return INVALID_ARGS;
+    return 1;
+}
+
+int main(int argc, char * argv[]){
+    TGenOptions options;
+    if (parseOptions(argc, argv, &options) == INVALID_ARGS){
+        fprintf(stderr, "Uso: benchGenerator [--rows=N] [--seed=S] [--from=AÑO] [--to=AÑO] [--genres=G] "
+                        "[--title=MIN-MAX] [archivo.csv]\n");
+        return EXIT_FAILURE;
+    }
+    FILE * out = options.outPath == NULL ? stdout : fopen(options.outPath, "w");
+    if (out == NULL){
+        fprintf(stderr, "El path ingresado es invalido\n");
+        return EXIT_FAILURE;
+    }
+
+    /// La semilla se mezcla (splitmix64) para que semillas consecutivas den secuencias distintas y nunca 0.
+    unsigned long long state = options.seed + 0x9E3779B97F4A7C15ULL;
+    state = (state ^ (state >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    state = (state ^ (state >> 27)) * 0x94D049BB133111EBULL;
+    state ^= state >> 31;
+    if (state == 0)
+        state = 1;
+
+    fputs("titleType;primaryTitle;startYear;endYear;genres;averageRating;numVotes;runtimeMinutes\n", out);
+    for (unsigned long i = 0; i < options.rows; i++)
+        writeRow(out, &state, &options);
+
+    int failed = ferror(out);
+    if (out != stdout)
+        failed |= fclose(out) != 0;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,332 @@
+#define _POSIX_C_SOURCE 200112L
+#include "mediaADT.h"
+#include "rowParser.h"
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+/**
+ * @file benchMedia.c
+ * @brief Benchmark de carga y consultas del mediaADT.
+ *
+ * @details Carga un .csv (por ejemplo, uno generado con benchGenerator) con parseRows() y addRawContent(), y mide
+ * las filas por segundo, el pico de memoria residente, la latencia de cada consulta y el tiempo de freeMediaADT().
+ * Cada consulta se ejecuta sobre una misma lista de casos (años, generos, rangos y titulos tomados del TAD, elegidos
+ * en forma deterministica) y se informa la latencia promedio, mediana, percentil 99 y maxima de cada llamada. El
+ * resultado se escribe como un objeto JSON en la salida estandar, para poder comparar distintas versiones.
+ *
+ * Uso: benchMedia [--samples=N] archivo.csv
+ */
+
+#define MIN_YEAR 1850         /**< @def Minimo año que aceptara el TAD de pelicula/serie (el mismo que imdb)  */
+#define DEFAULT_SAMPLES 20000 /**< @def Cantidad de llamadas por defecto a cada consulta                      */
+#define MAX_GENRES_CASES 4096 /**< @def Maxima cantidad de pares año x genero que se toman como casos         */
+#define MAX_TITLE_MATCHES 16  /**< @def Cantidad de resultados que se piden a las busquedas por titulo        */
+
+#define INVALID_PATH (-1)     /**< @def Codigo definido para indicar error de un Path que es invalido        */
+#define INVALID_ARGS (-2)     /**< @def Codigo definido para indicar error en los argumentos del programa    */
+
+/**
+ * @brief Caso sobre el que se ejecuta una consulta.
+ */
+typedef struct benchCase {
+    unsigned short year;              /**< Año de la consulta                          */
+    unsigned short to;                /**< Ultimo año, en las consultas por rango      */
+    const char * genre;               /**< Genero (apunta a memoria del TAD)           */
+    contentType type;                 /**< Tipo de contenido                           */
+    char title[MAX_TITLE_SIZE];       /**< Titulo o prefijo, en las busquedas          */
+} TBenchCase;
+
+/**
+ * @brief Consulta a medir: recibe el TAD y un caso, y devuelve un valor que se acumula para que no se descarte.
+ */
+typedef size_t (*benchQuery)(mediaADT media, const TBenchCase * item);
+
+/**
+ * @brief Contexto de la carga: TAD destino y cantidades de filas.
+ */
+typedef struct benchLoad {
+    mediaADT media;                   /**< TAD en el que se cargan las filas           */
+    size_t rows;                      /**< Filas leidas                                */
+    size_t inserted;                  /**< Filas añadidas al TAD                       */
+} TBenchLoad;
+
+/// Valores devueltos por las consultas: se acumulan y se informan para que el compilador no las elimine.
+static size_t benchSink;
+
+/**
+ * @brief Funcion auxiliar que devuelve el tiempo actual de un reloj monotonico, en nanosegundos.
+ */
+static unsigned long long nowNs(void){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve el pico de memoria residente del proceso, en KB.
+ */
+static long peakRssKb(void){
+    struct rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : -1;
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve el siguiente numero pseudoaleatorio (LCG de 64 bits), para elegir los casos
+ * siempre de la misma forma.
+ */
+static unsigned long nextRandom(unsigned long long * state){
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (unsigned long)(*state >> 33);
+}
+
+static void loadRow(void * context, int status, const TRawContent * row){
+    TBenchLoad * load = context;
+    load->rows++;
+    if (status != CONTENTTYPE_ERROR && addRawContent(load->media, row) > 0)
+        load->inserted++;
+}
+
+static size_t queryYear(mediaADT media, const TBenchCase * item){
+    return countContentByYear(media, item->year, item->type);
+}
+
+static size_t queryGenre(mediaADT media, const TBenchCase * item){
+    return countContentByGenre(media, item->year, item->genre, item->type);
+}
+
+static size_t queryYearRange(mediaADT media, const TBenchCase * item){
+    return countContentByYearRange(media, item->year, item->to, item->type);
+}
+
+static size_t queryGenreRange(mediaADT media, const TBenchCase * item){
+    return countContentByGenreRange(media, item->year, item->to, item->genre, item->type);
+}
+
+static size_t queryMostVoted(mediaADT media, const TBenchCase * item){
+    return mostVoted(media, item->year, item->type).numVotes;
+}
+
+static size_t queryGenreCursor(mediaADT media, const TBenchCase * item){
+    TGenreCursor cursor;
+    size_t count = 0;
+    if (toBeginGenreCursor(media, &cursor, item->year) == 1)
+        while (hasNextGenreCursor(media, &cursor))
+            count += nextGenreCursor(media, &cursor) != NULL;
+    return count;
+}
+
+static size_t queryTopCursor(mediaADT media, const TBenchCase * item){
+    TTopCursor cursor;
+    size_t votes = 0;
+    if (toBeginTopCursor(media, &cursor, item->year, item->genre, item->type) == 1)
+        while (hasNextTopCursor(&cursor))
+            votes += nextTopCursor(media, &cursor).numVotes;
+    return votes;
+}
+
+static size_t queryAggregate(mediaADT media, const TBenchCase * item){
+    TAggregate out;
+    aggregateContent(media, item->year, item->genre, item->type, FIELD_NUMVOTES, &out);
+    return out.count;
+}
+
+static size_t queryCountIf(mediaADT media, const TBenchCase * item){
+    return countContentIf(media, item->year, item->genre, item->type, FIELD_RATING, 7, 10);
+}
+
+static size_t queryRatingQuantile(mediaADT media, const TBenchCase * item){
+    return (size_t)(ratingQuantile(media, item->year, item->genre, item->type, 0.5) * 10);
+}
+
+static size_t queryRuntimeQuantile(mediaADT media, const TBenchCase * item){
+    return (size_t)runtimeQuantile(media, item->year, item->genre, item->type, 0.9);
+}
+
+static size_t queryTitle(mediaADT media, const TBenchCase * item){
+    TTitleMatch matches[MAX_TITLE_MATCHES];
+    return findTitle(media, item->title, matches, MAX_TITLE_MATCHES);
+}
+
+static size_t queryTitlePrefix(mediaADT media, const TBenchCase * item){
+    TTitleMatch matches[MAX_TITLE_MATCHES];
+    char prefix[4];
+    strncpy(prefix, item->title, sizeof(prefix) - 1);
+    prefix[sizeof(prefix) - 1] = '\0';
+    return findTitlePrefix(media, prefix, matches, MAX_TITLE_MATCHES);
+}
+
+/**
+ * @brief Consultas a medir, en el orden en que se informan.
+ */
+static const struct { const char * name; benchQuery query; } benchQueries[] = {
+    { "countContentByYear", queryYear },
+    { "countContentByGenre", queryGenre },
+    { "countContentByYearRange", queryYearRange },
+    { "countContentByGenreRange", queryGenreRange },
+    { "mostVoted", queryMostVoted },
+    { "genreCursor", queryGenreCursor },
+    { "topCursor", queryTopCursor },
+    { "aggregateContent", queryAggregate },
+    { "countContentIf", queryCountIf },
+    { "ratingQuantile", queryRatingQuantile },
+    { "runtimeQuantile", queryRuntimeQuantile },
+    { "findTitle", queryTitle },
+    { "findTitlePrefix", queryTitlePrefix }
+};
+
+#define BENCH_QUERIES (sizeof(benchQueries) / sizeof(benchQueries[0]))
+
+static int compareNs(const void * a, const void * b){
+    unsigned long long x = *(const unsigned long long *)a, y = *(const unsigned long long *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Funcion auxiliar que arma los casos: pares año x genero recorridos con los cursores, rangos de años y
+ * titulos existentes, elegidos con una semilla fija.
+ *
+ * @return Cantidad de casos armados (0 si el TAD esta vacio).
+ */
+static size_t buildCases(mediaADT media, TBenchCase * cases, const size_t samples){
+    static struct { unsigned short year; const char * genre; } pairs[MAX_GENRES_CASES];
+    size_t pairsCount = 0;
+    unsigned short minYear = 0, maxYear = 0;
+    TYearCursor years;
+    toBeginYearCursor(media, &years);
+    while (hasNextYearCursor(media, &years)){
+        unsigned short year = nextYearCursor(media, &years);
+        minYear = minYear == 0 || year < minYear ? year : minYear;
+        maxYear = year > maxYear ? year : maxYear;
+        TGenreCursor genres;
+        toBeginGenreCursor(media, &genres, year);
+        while (hasNextGenreCursor(media, &genres) && pairsCount < MAX_GENRES_CASES){
+            pairs[pairsCount].year = year;
+            pairs[pairsCount++].genre = nextGenreCursor(media, &genres);
+        }
+    }
+    if (pairsCount == 0)
+        return 0;
+
+    unsigned long long state = 1;
+    for (size_t i = 0; i < samples; i++){
+        size_t pair = nextRandom(&state) % pairsCount;
+        cases[i].year = pairs[pair].year;
+        cases[i].genre = pairs[pair].genre;
+        cases[i].type = nextRandom(&state) % 2 == 0 ? CONTENTTYPE_MOVIE : CONTENTTYPE_SERIES;
+        unsigned long span = nextRandom(&state) % (maxYear - cases[i].year + 1);
+        cases[i].to = cases[i].year + span;
+
+        /// Titulo existente: el primero que comienza con dos letras al azar (si no hay, queda un prefijo sin resultados).
+        TTitleMatch match;
+        char prefix[3] = { 'A' + nextRandom(&state) % 26, 'a' + nextRandom(&state) % 26, '\0' };
+        if (findTitlePrefix(media, prefix, &match, 1) > 0){
+            strncpy(cases[i].title, match.primaryTitle, MAX_TITLE_SIZE - 1);
+            cases[i].title[MAX_TITLE_SIZE - 1] = '\0';
+        }
+        else
+            strcpy(cases[i].title, prefix);
+    }
+    return samples;
+}
+
+/**
+ * @brief Funcion auxiliar que mide una consulta sobre todos los casos y escribe sus latencias en JSON.
+ */
+static void runQuery(mediaADT media, const size_t query, const TBenchCase * cases, const size_t count,
+                     unsigned long long * latencies){
+    unsigned long long total = 0;
+    for (size_t i = 0; i < count; i++){
+        unsigned long long start = nowNs();
+        benchSink += benchQueries[query].query(media, &cases[i]);
+        latencies[i] = nowNs() - start;
+        total += latencies[i];
+    }
+    qsort(latencies, count, sizeof(unsigned long long), compareNs);
+    printf("    {\"name\": \"%s\", \"calls\": %zu, \"mean_ns\": %.1f, \"p50_ns\": %llu, \"p99_ns\": %llu, "
+           "\"max_ns\": %llu}%s\n", benchQueries[query].name, count, (double)total / count, latencies[count / 2],
+           latencies[count * 99 / 100], latencies[count - 1], query + 1 < BENCH_QUERIES ? "," : "");
+}
+
+int main(int argc, char * argv[]){
+    const char * path = NULL;
+    size_t samples = DEFAULT_SAMPLES;
+    for (int i = 1; i < argc; i++){
+        if (strncmp(argv[i], "--samples=", 10) == 0 && (samples = strtoul(argv[i] + 10, NULL, 10)) > 0)
+            continue;
+        if (argv[i][0] == '-' || path != NULL){
+            fprintf(stderr, "Uso: benchMedia [--samples=N] archivo.csv\n");
+            return INVALID_ARGS;
+        }
+        path = argv[i];
+    }
+    if (path == NULL){
+        fprintf(stderr, "Uso: benchMedia [--samples=N] archivo.csv\n");
+        return INVALID_ARGS;
+    }
+
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    if (fd == -1 || fstat(fd, &info) != 0){
+        fprintf(stderr, "El path ingresado es invalido\n");
+        return INVALID_PATH;
+    }
+    size_t size = (size_t)info.st_size;
+    char * data = size == 0 ? NULL : mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED || data == NULL){
+        fprintf(stderr, "El path ingresado es invalido\n");
+        return INVALID_PATH;
+    }
+    const char * rows = memchr(data, '\n', size);
+    rows = rows == NULL ? data + size : rows + 1;
+
+    /// Carga: se mide la separacion en filas y la insercion en el TAD, sin contar la lectura previa del archivo.
+    TBenchLoad load = { newMediaADT(MIN_YEAR, NULL, MEDIA_FULL), 0, 0 };
+    if (load.media == NULL){
+        fprintf(stderr, "Error en asignacion de memoria \n");
+        return MEM_ERROR;
+    }
+    posix_madvise(data, size, POSIX_MADV_WILLNEED);
+    unsigned long long start = nowNs();
+    parseRows(rows, data + size - rows, loadRow, &load);
+    unsigned long long ingestNs = nowNs() - start;
+    long ingestRss = peakRssKb();
+
+    start = nowNs();
+    int indexed = indexTitles(load.media);
+    unsigned long long indexNs = nowNs() - start;
+
+    TBenchCase * cases = malloc(sizeof(TBenchCase) * samples);
+    unsigned long long * latencies = malloc(sizeof(unsigned long long) * samples);
+    if (indexed != 1 || cases == NULL || latencies == NULL){
+        fprintf(stderr, "Error en asignacion de memoria \n");
+        return MEM_ERROR;
+    }
+    size_t count = buildCases(load.media, cases, samples);
+
+    printf("{\n  \"file\": \"%s\",\n  \"rows\": %zu,\n  \"inserted\": %zu,\n", path, load.rows, load.inserted);
+    printf("  \"ingest_s\": %.6f,\n  \"ingest_rows_per_s\": %.0f,\n", ingestNs / 1e9,
+           ingestNs == 0 ? 0 : load.rows / (ingestNs / 1e9));
+    printf("  \"arena_reserved_bytes\": %zu,\n  \"arena_used_bytes\": %zu,\n", mediaReservedBytes(load.media),
+           mediaUsedBytes(load.media));
+    printf("  \"ingest_peak_rss_kb\": %ld,\n  \"index_titles_ms\": %.3f,\n  \"queries\": [\n", ingestRss,
+           indexNs / 1e6);
+    for (size_t i = 0; count > 0 && i < BENCH_QUERIES; i++)
+        runQuery(load.media, i, cases, count, latencies);
+    printf("  ],\n  \"peak_rss_kb\": %ld,\n", peakRssKb());
+
+    start = nowNs();
+    freeMediaADT(load.media);
+    printf("  \"free_ms\": %.3f,\n  \"checksum\": %zu\n}\n", (nowNs() - start) / 1e6, benchSink);
+
+    free(cases);
+    free(latencies);
+    munmap(data, size);
+    return 0;
+}
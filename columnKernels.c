@@ -0,0 +1,224 @@
+#include "columnKernels.h"
+#include <string.h>
+#include <float.h>
+#include <limits.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define KERNEL_LANES 8        /**< @def Cantidad de acumuladores independientes de las versiones escalares */
+
+/**
+ * @brief Funcion auxiliar que combina en "out" el resultado parcial de un kernel.
+ */
+static void mergeAggregate(TAggregate * out, size_t count, double sum, double min, double max){
+    if (count == 0)
+        return;
+    if (out->count == 0 || min < out->min)
+        out->min = min;
+    if (out->count == 0 || max > out->max)
+        out->max = max;
+    out->sum += sum;
+    out->count += count;
+}
+
+void maskEquals8(const unsigned char * values, unsigned char wanted, unsigned char * mask, size_t n){
+    for (size_t i = 0; i < n; i++)
+        mask[i] = values[i] == wanted;
+}
+
+void maskAndEquals16(const unsigned short * values, unsigned short wanted, unsigned char * mask, size_t n){
+    for (size_t i = 0; i < n; i++)
+        mask[i] &= values[i] == wanted;
+}
+
+/**
+ * @brief Macro que define la version escalar de un kernel de agregacion para columnas de tipo TYPE, desde "i".
+ *
+ * @details Los valores no considerados se reemplazan por el neutro de cada operacion (0 para la suma, MAXV para el
+ * minimo y MINV para el maximo), por lo que el cuerpo no tiene saltos. Cada una de las KERNEL_LANES posiciones tiene
+ * sus propios acumuladores, que se combinan al final.
+ */
+#define AGGREGATE_SCALAR(TYPE, ACC, MINV, MAXV)                                                         \
+{                                                                                                       \
+    ACC sum[KERNEL_LANES] = {0};                                                                        \
+    size_t count[KERNEL_LANES] = {0};                                                                   \
+    TYPE min[KERNEL_LANES], max[KERNEL_LANES];                                                          \
+    for (size_t j = 0; j < KERNEL_LANES; j++){                                                          \
+        min[j] = (MAXV);                                                                                \
+        max[j] = (MINV);                                                                                \
+    }                                                                                                   \
+    for (; i < n; i++){                                                                                 \
+        size_t j = i % KERNEL_LANES;                                                                    \
+        TYPE v = values[i];                                                                             \
+        int m = mask[i] != 0;                                                                           \
+        sum[j] += m ? v : 0;                                                                            \
+        count[j] += m;                                                                                  \
+        min[j] = m && v < min[j] ? v : min[j];                                                          \
+        max[j] = m && v > max[j] ? v : max[j];                                                          \
+    }                                                                                                   \
+    for (size_t j = 0; j < KERNEL_LANES; j++)                                                           \
+        mergeAggregate(out, count[j], sum[j], min[j], max[j]);                                          \
+}
+
+/**
+ * @brief Macro que define la version escalar de un kernel que cuenta valores en [lo, hi], desde "i".
+ */
+#define COUNT_RANGE_SCALAR(total)                                                                       \
+    for (; i < n; i++)                                                                                  \
+        total += (mask[i] != 0) & (values[i] >= lo) & (values[i] <= hi);
+
+void aggregateU64(const unsigned long * values, const unsigned char * mask, size_t n, TAggregate * out){
+    /// SSE2 no compara enteros de 64 bits, por lo que esta columna siempre utiliza la version escalar.
+    size_t i = 0;
+    AGGREGATE_SCALAR(unsigned long, unsigned long, 0, ULONG_MAX)
+}
+
+size_t countRangeU64(const unsigned long * values, const unsigned char * mask, size_t n, unsigned long lo,
+                     unsigned long hi){
+    size_t i = 0, total = 0;
+    COUNT_RANGE_SCALAR(total)
+    return total;
+}
+
+#if defined(__SSE2__)
+
+/**
+ * @brief Funcion auxiliar que suma los bytes de una mascara de 8 bytes (la cantidad de valores considerados).
+ */
+static size_t maskCount8(__m128i mask8){
+    return (size_t)_mm_cvtsi128_si32(_mm_sad_epu8(mask8, _mm_setzero_si128()));
+}
+
+void aggregateU16(const unsigned short * values, const unsigned char * mask, size_t n, TAggregate * out){
+    /// Los valores sin signo se desplazan en 0x8000 para poder compararlos con las instrucciones con signo.
+    const __m128i zero = _mm_setzero_si128(), bias = _mm_set1_epi16((short)0x8000);
+    __m128i sumLo = zero, sumHi = zero;
+    __m128i min = _mm_set1_epi16(SHRT_MAX), max = _mm_set1_epi16(SHRT_MIN);
+    size_t count = 0, i = 0;
+    for (; i + 8 <= n; i += 8){
+        __m128i v = _mm_loadu_si128((const __m128i *)(values + i));
+        __m128i mask8 = _mm_loadl_epi64((const __m128i *)(mask + i));
+        __m128i m = _mm_cmpgt_epi16(_mm_unpacklo_epi8(mask8, zero), zero);
+        __m128i vm = _mm_and_si128(v, m);
+        __m128i v32Lo = _mm_unpacklo_epi16(vm, zero), v32Hi = _mm_unpackhi_epi16(vm, zero);
+        sumLo = _mm_add_epi64(sumLo, _mm_add_epi64(_mm_unpacklo_epi32(v32Lo, zero), _mm_unpackhi_epi32(v32Lo, zero)));
+        sumHi = _mm_add_epi64(sumHi, _mm_add_epi64(_mm_unpacklo_epi32(v32Hi, zero), _mm_unpackhi_epi32(v32Hi, zero)));
+        count += maskCount8(mask8);
+        __m128i s = _mm_xor_si128(v, bias);
+        min = _mm_min_epi16(min, _mm_or_si128(_mm_and_si128(m, s), _mm_andnot_si128(m, _mm_set1_epi16(SHRT_MAX))));
+        max = _mm_max_epi16(max, _mm_or_si128(_mm_and_si128(m, s), _mm_andnot_si128(m, _mm_set1_epi16(SHRT_MIN))));
+    }
+    if (count > 0){
+        unsigned long sums[4];
+        short mins[8], maxs[8];
+        _mm_storeu_si128((__m128i *)sums, sumLo);
+        _mm_storeu_si128((__m128i *)(sums + 2), sumHi);
+        _mm_storeu_si128((__m128i *)mins, min);
+        _mm_storeu_si128((__m128i *)maxs, max);
+        short lowest = SHRT_MAX, highest = SHRT_MIN;
+        for (size_t j = 0; j < 8; j++){
+            lowest = mins[j] < lowest ? mins[j] : lowest;
+            highest = maxs[j] > highest ? maxs[j] : highest;
+        }
+        mergeAggregate(out, count, (double)(sums[0] + sums[1] + sums[2] + sums[3]),
+                       (unsigned short)(lowest ^ (short)0x8000), (unsigned short)(highest ^ (short)0x8000));
+    }
+    AGGREGATE_SCALAR(unsigned short, unsigned long, 0, USHRT_MAX)
+}
+
+size_t countRangeU16(const unsigned short * values, const unsigned char * mask, size_t n, unsigned short lo,
+                     unsigned short hi){
+    const __m128i zero = _mm_setzero_si128(), bias = _mm_set1_epi16((short)0x8000);
+    const __m128i below = _mm_set1_epi16((short)(lo ^ 0x8000)), above = _mm_set1_epi16((short)(hi ^ 0x8000));
+    size_t total = 0, i = 0;
+    for (; i + 8 <= n; i += 8){
+        __m128i s = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(values + i)), bias);
+        __m128i m = _mm_cmpgt_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(mask + i)), zero), zero);
+        /// Fuera de rango: s < lo o s > hi.
+        __m128i out = _mm_or_si128(_mm_cmplt_epi16(s, below), _mm_cmpgt_epi16(s, above));
+        total += __builtin_popcount(_mm_movemask_epi8(_mm_andnot_si128(out, m))) / 2;
+    }
+    COUNT_RANGE_SCALAR(total)
+    return total;
+}
+
+void aggregateF32(const float * values, const unsigned char * mask, size_t n, TAggregate * out){
+    const __m128i zero = _mm_setzero_si128();
+    __m128d sumLo = _mm_setzero_pd(), sumHi = _mm_setzero_pd();
+    __m128 min = _mm_set1_ps(FLT_MAX), max = _mm_set1_ps(-FLT_MAX);
+    size_t count = 0, i = 0;
+    for (; i + 4 <= n; i += 4){
+        __m128 v = _mm_loadu_ps(values + i);
+        int bytes;
+        memcpy(&bytes, mask + i, sizeof(bytes));
+        __m128i mask4 = _mm_cvtsi32_si128(bytes);
+        __m128 m = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_unpacklo_epi16(_mm_unpacklo_epi8(mask4, zero), zero), zero));
+        __m128 vm = _mm_and_ps(v, m);
+        sumLo = _mm_add_pd(sumLo, _mm_cvtps_pd(vm));
+        sumHi = _mm_add_pd(sumHi, _mm_cvtps_pd(_mm_movehl_ps(vm, vm)));
+        count += __builtin_popcount(_mm_movemask_ps(m));
+        min = _mm_min_ps(min, _mm_or_ps(vm, _mm_andnot_ps(m, _mm_set1_ps(FLT_MAX))));
+        max = _mm_max_ps(max, _mm_or_ps(vm, _mm_andnot_ps(m, _mm_set1_ps(-FLT_MAX))));
+    }
+    if (count > 0){
+        double sums[4];
+        float mins[4], maxs[4];
+        _mm_storeu_pd(sums, sumLo);
+        _mm_storeu_pd(sums + 2, sumHi);
+        _mm_storeu_ps(mins, min);
+        _mm_storeu_ps(maxs, max);
+        float lowest = FLT_MAX, highest = -FLT_MAX;
+        for (size_t j = 0; j < 4; j++){
+            lowest = mins[j] < lowest ? mins[j] : lowest;
+            highest = maxs[j] > highest ? maxs[j] : highest;
+        }
+        mergeAggregate(out, count, sums[0] + sums[1] + sums[2] + sums[3], lowest, highest);
+    }
+    AGGREGATE_SCALAR(float, double, -FLT_MAX, FLT_MAX)
+}
+
+size_t countRangeF32(const float * values, const unsigned char * mask, size_t n, float lo, float hi){
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 below = _mm_set1_ps(lo), above = _mm_set1_ps(hi);
+    size_t total = 0, i = 0;
+    for (; i + 4 <= n; i += 4){
+        __m128 v = _mm_loadu_ps(values + i);
+        int bytes;
+        memcpy(&bytes, mask + i, sizeof(bytes));
+        __m128i mask4 = _mm_cvtsi32_si128(bytes);
+        __m128 m = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_unpacklo_epi16(_mm_unpacklo_epi8(mask4, zero), zero), zero));
+        __m128 in = _mm_and_ps(_mm_cmpge_ps(v, below), _mm_cmple_ps(v, above));
+        total += __builtin_popcount(_mm_movemask_ps(_mm_and_ps(in, m)));
+    }
+    COUNT_RANGE_SCALAR(total)
+    return total;
+}
+
+#else
+
+void aggregateU16(const unsigned short * values, const unsigned char * mask, size_t n, TAggregate * out){
+    size_t i = 0;
+    AGGREGATE_SCALAR(unsigned short, unsigned long, 0, USHRT_MAX)
+}
+
+size_t countRangeU16(const unsigned short * values, const unsigned char * mask, size_t n, unsigned short lo,
+                     unsigned short hi){
+    size_t i = 0, total = 0;
+    COUNT_RANGE_SCALAR(total)
+    return total;
+}
+
+void aggregateF32(const float * values, const unsigned char * mask, size_t n, TAggregate * out){
+    size_t i = 0;
+    AGGREGATE_SCALAR(float, double, -FLT_MAX, FLT_MAX)
+}
+
+size_t countRangeF32(const float * values, const unsigned char * mask, size_t n, float lo, float hi){
+    size_t i = 0, total = 0;
+    COUNT_RANGE_SCALAR(total)
+    return total;
+}
+
+#endif
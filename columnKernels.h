@@ -0,0 +1,76 @@
+#ifndef TPEFINAL_COLUMNKERNELS_H
+#define TPEFINAL_COLUMNKERNELS_H
+
+#include <stddef.h>
+
+/**
+ * @brief Resultado de agregar una columna: cantidad, suma, minimo y maximo de los valores considerados.
+ */
+typedef struct aggregate {
+    size_t count;              /**< Cantidad de valores considerados           */
+    double sum;                /**< Suma de los valores                        */
+    double min;                /**< Minimo de los valores (0 si count es 0)    */
+    double max;                /**< Maximo de los valores (0 si count es 0)    */
+} TAggregate;
+
+/*******************************************************************************
+ *  @section Kernels
+ *  @brief Funciones que recorren columnas contiguas de valores numericos.
+ *
+ *  @details Cada funcion recibe una mascara de bytes (1 si el valor se considera,
+ *  0 si no) en lugar de ramificar por fila. Las columnas de float y de enteros de
+ *  16 bits se procesan con instrucciones SSE2 (4 u 8 valores a la vez); la de
+ *  enteros de 64 bits, y todas en arquitecturas sin SSE2, con una version escalar
+ *  sin saltos y con acumuladores independientes. Las funciones de agregacion
+ *  acumulan sobre "out", por lo que pueden llamarse una vez por bloque.
+********************************************************************************/
+
+/**
+ * @brief Funcion que arma una mascara con los valores de una columna de bytes iguales a "wanted".
+ *
+ * @param values Columna.
+ * @param wanted Valor buscado.
+ * @param mask Mascara a completar (1 si values[i] == wanted, 0 si no).
+ * @param n Cantidad de valores.
+ */
+void maskEquals8(const unsigned char * values, unsigned char wanted, unsigned char * mask, size_t n);
+
+/**
+ * @brief Funcion que restringe una mascara a los valores de una columna iguales a "wanted".
+ *
+ * @param values Columna.
+ * @param wanted Valor buscado.
+ * @param mask Mascara a restringir (queda en 0 donde values[i] != wanted).
+ * @param n Cantidad de valores.
+ */
+void maskAndEquals16(const unsigned short * values, unsigned short wanted, unsigned char * mask, size_t n);
+
+/**
+ * @brief Funciones que acumulan en "out" la cantidad, suma, minimo y maximo de los valores indicados por la mascara.
+ *
+ * @param values Columna.
+ * @param mask Mascara de valores a considerar.
+ * @param n Cantidad de valores.
+ * @param out Resultado acumulado (debe comenzar con count en 0).
+ */
+void aggregateU64(const unsigned long * values, const unsigned char * mask, size_t n, TAggregate * out);
+void aggregateU16(const unsigned short * values, const unsigned char * mask, size_t n, TAggregate * out);
+void aggregateF32(const float * values, const unsigned char * mask, size_t n, TAggregate * out);
+
+/**
+ * @brief Funciones que cuentan los valores indicados por la mascara que se encuentran en [lo, hi].
+ *
+ * @param values Columna.
+ * @param mask Mascara de valores a considerar.
+ * @param n Cantidad de valores.
+ * @param lo Extremo inferior (incluido).
+ * @param hi Extremo superior (incluido).
+ * @return Cantidad de valores en el rango.
+ */
+size_t countRangeU64(const unsigned long * values, const unsigned char * mask, size_t n, unsigned long lo,
+                     unsigned long hi);
+size_t countRangeU16(const unsigned short * values, const unsigned char * mask, size_t n, unsigned short lo,
+                     unsigned short hi);
+size_t countRangeF32(const float * values, const unsigned char * mask, size_t n, float lo, float hi);
+
+#endif //TPEFINAL_COLUMNKERNELS_H
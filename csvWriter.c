@@ -0,0 +1,147 @@
+#define _POSIX_C_SOURCE 200112L
+#include "csvWriter.h"
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define WRITER_BUFFER (1 << 18) /**< @def Tamaño del buffer de escritura                                  */
+#define WRITER_ALIGN 4096       /**< @def Alineacion del buffer (una pagina)                              */
+#define NUMBER_SIZE 24          /**< @def Maxima cantidad de caracteres de un numero formateado           */
+
+/**
+ * @brief Archivo de salida con escritura en buffer.
+ */
+typedef struct writerCDT {
+    int fd;                     /**< Descriptor del archivo                              */
+    char * buffer;              /**< Buffer de WRITER_BUFFER bytes alineado a pagina     */
+    size_t used;                /**< Bytes ocupados del buffer                           */
+    int failed;                 /**< 1 si alguna escritura fallo                         */
+} writerCDT;
+
+writerADT newWriterADT(const char * filePath)
+{
+    writerADT new = calloc(1, sizeof(writerCDT));
+    if (new == NULL)
+        return NULL;
+    void * buffer;
+    if (posix_memalign(&buffer, WRITER_ALIGN, WRITER_BUFFER) != 0) {
+        free(new);
+        return NULL;
+    }
+    new->buffer = buffer;
+    if ((new->fd = open(filePath, O_WRONLY | O_CREAT | O_TRUNC, 0644)) == -1) {
+        free(new->buffer);
+        free(new);
+        return NULL;
+    }
+    return new;
+}
+
+/**
+ * @brief Funcion auxiliar que escribe "len" bytes en el archivo, reintentando las escrituras parciales.
+ */
+static void writeAll(writerADT writer, const char * data, size_t len)
+{
+    while (len > 0 && !writer->failed) {
+        ssize_t out = write(writer->fd, data, len);
+        if (out < 0 && errno == EINTR)
+            continue;
+        if (out <= 0) {
+            writer->failed = 1;
+            return;
+        }
+        data += out;
+        len -= out;
+    }
+}
+
+/**
+ * @brief Funcion auxiliar que vacia el buffer con una unica escritura.
+ */
+static void flush(writerADT writer)
+{
+    writeAll(writer, writer->buffer, writer->used);
+    writer->used = 0;
+}
+
+/**
+ * @brief Funcion auxiliar que copia "len" bytes al buffer, vaciandolo antes si no hay lugar.
+ */
+static void put(writerADT writer, const char * data, size_t len)
+{
+    if (writer->used + len > WRITER_BUFFER) {
+        flush(writer);
+        /// Un dato mas grande que el buffer se escribe directamente.
+        if (len > WRITER_BUFFER) {
+            writeAll(writer, data, len);
+            return;
+        }
+    }
+    memcpy(writer->buffer + writer->used, data, len);
+    writer->used += len;
+}
+
+void writeText(writerADT writer, const char * text)
+{
+    put(writer, text, strlen(text));
+}
+
+void writeChar(writerADT writer, char c)
+{
+    if (writer->used == WRITER_BUFFER)
+        flush(writer);
+    writer->buffer[writer->used++] = c;
+}
+
+/**
+ * @brief Funcion auxiliar que formatea un entero sin signo hacia atras desde "end".
+ *
+ * @return Comienzo del numero formateado.
+ */
+static char * formatUnsigned(char * end, unsigned long value)
+{
+    do {
+        *--end = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    return end;
+}
+
+void writeUnsigned(writerADT writer, unsigned long value)
+{
+    char number[NUMBER_SIZE];
+    char * start = formatUnsigned(number + NUMBER_SIZE, value);
+    put(writer, start, number + NUMBER_SIZE - start);
+}
+
+void writeDecimal(writerADT writer, float value)
+{
+    char number[NUMBER_SIZE];
+    char * end = number + NUMBER_SIZE;
+    /// Un float tiene 24 bits de mantisa, por lo que value * 10 es exacto en double y el redondeo coincide con printf.
+    double tenths = (double)value * 10;
+    int negative = tenths < 0;
+    if (negative)
+        tenths = -tenths;
+    unsigned long rounded = (unsigned long)tenths;
+    double fraction = tenths - rounded;
+    if (fraction > 0.5 || (fraction == 0.5 && rounded % 2 == 1))
+        rounded++;
+    *--end = (char)('0' + rounded % 10);
+    *--end = '.';
+    char * start = formatUnsigned(end, rounded / 10);
+    /// printf conserva el signo de los valores negativos que redondean a cero ("-0.0").
+    if (negative)
+        *--start = '-';
+    put(writer, start, number + NUMBER_SIZE - start);
+}
+
+int closeWriterADT(writerADT writer)
+{
+    flush(writer);
+    int out = close(writer->fd) == 0 && !writer->failed;
+    free(writer->buffer);
+    free(writer);
+    return out;
+}
@@ -0,0 +1,49 @@
+#ifndef TPEFINAL_CSVWRITER_H
+#define TPEFINAL_CSVWRITER_H
+
+#include <stdlib.h>
+
+typedef struct writerCDT * writerADT;
+
+/**
+ * @brief Funcion que crea un archivo de salida con escritura en buffer.
+ *
+ * @details Los datos se acumulan en un buffer grande alineado a pagina y se escriben con una unica llamada a write()
+ * cada vez que se llena (o al cerrar). Los numeros se formatean sin printf, por lo que no se interpreta un formato ni
+ * se consulta el locale en cada linea.
+ *
+ * @param filePath Archivo destino. Si existe, se reemplaza su contenido.
+ * @return writerADT creado o NULL si no se pudo crear el archivo o reservar memoria.
+ */
+writerADT newWriterADT(const char * filePath);
+
+/**
+ * @brief Funcion que escribe un texto terminado en '\0'.
+ */
+void writeText(writerADT writer, const char * text);
+
+/**
+ * @brief Funcion que escribe un caracter.
+ */
+void writeChar(writerADT writer, char c);
+
+/**
+ * @brief Funcion que escribe un entero sin signo en base 10 (igual que "%lu").
+ */
+void writeUnsigned(writerADT writer, unsigned long value);
+
+/**
+ * @brief Funcion que escribe un float con un decimal, con el mismo redondeo que "%.1f" (al mas cercano y, ante un
+ * empate exacto, al decimal par). Pensada para valores de magnitud menor a 10^17, como los puntajes.
+ */
+void writeDecimal(writerADT writer, float value);
+
+/**
+ * @brief Funcion que escribe lo que quede en el buffer, cierra el archivo y libera los recursos del writerADT.
+ *
+ * @param writer Archivo de salida.
+ * @return 1 si todos los datos se escribieron correctamente o 0 si alguna escritura fallo.
+ */
+int closeWriterADT(writerADT writer);
+
+#endif //TPEFINAL_CSVWRITER_H
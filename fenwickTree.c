@@ -0,0 +1,34 @@
+#include "fenwickTree.h"
+
+/// Bit menos significativo en 1 de una posicion: la cantidad de posiciones que acumula.
+#define LOWBIT(I) ((I) & (~(I) + 1))
+
+void fenwickBuild(size_t * tree, size_t n){
+    /// Cada posicion, ya completa, se acumula en la siguiente que la cubre.
+    for (size_t i = 1; i <= n; i++){
+        size_t parent = i + LOWBIT(i);
+        if (parent <= n)
+            tree[parent] += tree[i];
+    }
+}
+
+void fenwickAdd(size_t * tree, size_t n, size_t pos, size_t delta){
+    for (size_t i = pos + 1; i <= n; i += LOWBIT(i))
+        tree[i] += delta;
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve la suma de las primeras "count" posiciones.
+ */
+static size_t fenwickPrefix(const size_t * tree, size_t count){
+    size_t sum = 0;
+    for (size_t i = count; i > 0; i -= LOWBIT(i))
+        sum += tree[i];
+    return sum;
+}
+
+size_t fenwickRange(const size_t * tree, size_t from, size_t to){
+    if (from > to)
+        return 0;
+    return fenwickPrefix(tree, to + 1) - fenwickPrefix(tree, from);
+}
@@ -0,0 +1,44 @@
+#ifndef TPEFINAL_FENWICKTREE_H
+#define TPEFINAL_FENWICKTREE_H
+
+#include <stddef.h>
+
+/**
+ * @brief Arbol de Fenwick (binary indexed tree) sobre un vector de "n" cantidades.
+ *
+ * @details Se guarda en un vector de n + 1 posiciones en el que la posicion i (desde 1) acumula las cantidades de
+ * (i - lowbit(i), i], por lo que sumar una cantidad a una posicion y consultar la suma de un rango cuestan O(log n).
+ * Las cuentas son modulo 2^N: restar una cantidad se hace sumando su complemento, y las sumas de rangos son correctas
+ * mientras el resultado no sea negativo.
+ */
+
+/**
+ * @brief Funcion que arma en el lugar un arbol a partir de un vector con la cantidad de cada posicion en las
+ * posiciones 1 a n (la posicion 0 no se utiliza). Cuesta O(n).
+ *
+ * @param tree Vector de n + 1 posiciones.
+ * @param n Cantidad de posiciones del vector original.
+ */
+void fenwickBuild(size_t * tree, size_t n);
+
+/**
+ * @brief Funcion que suma "delta" a la cantidad de una posicion.
+ *
+ * @param tree Arbol a actualizar.
+ * @param n Cantidad de posiciones del arbol.
+ * @param pos Posicion (desde 0) a actualizar.
+ * @param delta Cantidad a sumar ((size_t)-k para restar k).
+ */
+void fenwickAdd(size_t * tree, size_t n, size_t pos, size_t delta);
+
+/**
+ * @brief Funcion que devuelve la suma de las cantidades de las posiciones [from, to] (desde 0).
+ *
+ * @param tree Arbol a consultar.
+ * @param from Primera posicion del rango.
+ * @param to Ultima posicion del rango, menor a la cantidad de posiciones del arbol.
+ * @return Suma del rango (0 si from > to).
+ */
+size_t fenwickRange(const size_t * tree, size_t from, size_t to);
+
+#endif //TPEFINAL_FENWICKTREE_H
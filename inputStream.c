@@ -0,0 +1,314 @@
+#define _POSIX_C_SOURCE 200112L
+#include "inputStream.h"
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef MEDIA_GZIP
+#include <zlib.h>
+#endif
+#ifdef MEDIA_ZSTD
+#include <zstd.h>
+#endif
+
+#define STREAM_BUFFER (1 << 17) /**< @def Tamaño del buffer de datos comprimidos                          */
+
+static const unsigned char GZIP_MAGIC[] = {0x1f, 0x8b};             /**< Primeros bytes de un archivo gzip */
+static const unsigned char ZSTD_MAGIC[] = {0x28, 0xb5, 0x2f, 0xfd}; /**< Primeros bytes de un archivo zstd */
+
+/**
+ * @brief Archivo de entrada leido en orden.
+ */
+typedef struct streamCDT {
+    streamFormat format;        /**< Formato del archivo                                         */
+    int fd;                     /**< Descriptor del archivo (0 para la entrada estandar)         */
+    int failed;                 /**< 1 si se produjo un error de lectura o descompresion         */
+    unsigned char * inputData;  /**< Buffer de STREAM_BUFFER bytes leidos del descriptor         */
+    size_t inputPos;            /**< Primer byte de inputData aun no consumido                   */
+    size_t inputSize;           /**< Cantidad de bytes validos en inputData                      */
+    int inputEnd;               /**< 1 si ya se leyo todo el descriptor                          */
+    int frameEnd;               /**< 1 si el ultimo miembro/frame leido termino y se entrego completo */
+#ifdef MEDIA_GZIP
+    z_stream gzip;              /**< Descompresor (formato STREAM_GZIP)                          */
+    int gzipReady;              /**< 1 si se inicializo el descompresor gzip                     */
+#endif
+#ifdef MEDIA_ZSTD
+    ZSTD_DStream * zstd;        /**< Descompresor (formato STREAM_ZSTD)                          */
+#endif
+} streamCDT;
+
+/**
+ * @brief Funcion auxiliar que determina el formato a partir de los primeros bytes leidos.
+ */
+static streamFormat formatOf(const unsigned char * magic, size_t n)
+{
+    if (n >= sizeof(GZIP_MAGIC) && memcmp(magic, GZIP_MAGIC, sizeof(GZIP_MAGIC)) == 0)
+        return STREAM_GZIP;
+    if (n >= sizeof(ZSTD_MAGIC) && memcmp(magic, ZSTD_MAGIC, sizeof(ZSTD_MAGIC)) == 0)
+        return STREAM_ZSTD;
+    return STREAM_PLAIN;
+}
+
+/**
+ * @brief Funcion auxiliar que lee bytes del descriptor del archivo, reintentando si la lectura fue interrumpida.
+ *
+ * @return Cantidad de bytes leidos, 0 al final del archivo o -1 ante un error.
+ */
+static ssize_t readFile(int fd, void * buffer, size_t len)
+{
+    ssize_t n;
+    while ((n = read(fd, buffer, len)) == -1 && errno == EINTR)
+        ;
+    return n;
+}
+
+streamFormat detectStreamFormat(const char * filePath)
+{
+    /// La entrada estandar no puede leerse dos veces; su formato se determina al abrirla con newStreamADT().
+    if (strcmp(filePath, STDIN_PATH) == 0)
+        return STREAM_PLAIN;
+    unsigned char magic[sizeof(ZSTD_MAGIC)];
+    int fd = open(filePath, O_RDONLY);
+    if (fd == -1)
+        return STREAM_PLAIN;
+    ssize_t n = readFile(fd, magic, sizeof(magic));
+    close(fd);
+    return formatOf(magic, n < 0 ? 0 : (size_t)n);
+}
+
+int isStreamFormatSupported(streamFormat format)
+{
+    switch (format) {
+        case STREAM_PLAIN:
+            return 1;
+#ifdef MEDIA_GZIP
+        case STREAM_GZIP:
+            return 1;
+#endif
+#ifdef MEDIA_ZSTD
+        case STREAM_ZSTD:
+            return 1;
+#endif
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Funcion auxiliar que lee los primeros bytes del archivo en el buffer de entrada (sin consumirlos) para
+ * determinar su formato. Una tuberia puede entregarlos de a poco, por lo que se lee hasta tenerlos o llegar al final.
+ *
+ * @return 1 si se leyeron correctamente o 0 ante un error de lectura.
+ */
+static int peekFormat(streamADT stream)
+{
+    while (stream->inputSize < sizeof(ZSTD_MAGIC)) {
+        ssize_t n = readFile(stream->fd, stream->inputData + stream->inputSize, STREAM_BUFFER - stream->inputSize);
+        if (n == -1)
+            return 0;
+        if (n == 0) {
+            stream->inputEnd = 1;
+            break;
+        }
+        stream->inputSize += (size_t)n;
+    }
+    stream->format = formatOf(stream->inputData, stream->inputSize);
+    return 1;
+}
+
+streamADT newStreamADT(const char * filePath)
+{
+    int isStdin = strcmp(filePath, STDIN_PATH) == 0;
+    streamADT new = calloc(1, sizeof(streamCDT));
+    if (new == NULL)
+        return NULL;
+    new->inputData = malloc(STREAM_BUFFER);
+    if (new->inputData == NULL || (new->fd = isStdin ? STDIN_FILENO : open(filePath, O_RDONLY)) == -1) {
+        free(new->inputData);
+        free(new);
+        return NULL;
+    }
+    if (!isStdin)
+        posix_fadvise(new->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    if (!peekFormat(new) || !isStreamFormatSupported(new->format)) {
+        /// Un archivo se descarta; la entrada estandar ya fue consumida, por lo que el error se informa al leerla.
+        if (!isStdin) {
+            freeStreamADT(new);
+            return NULL;
+        }
+        new->failed = 1;
+        return new;
+    }
+
+#ifdef MEDIA_GZIP
+    if (new->format == STREAM_GZIP) {
+        /// 16 + MAX_WBITS: solo se aceptan datos con encabezado gzip.
+        if (inflateInit2(&new->gzip, 16 + MAX_WBITS) != Z_OK) {
+            freeStreamADT(new);
+            return NULL;
+        }
+        new->gzipReady = 1;
+    }
+#endif
+#ifdef MEDIA_ZSTD
+    if (new->format == STREAM_ZSTD) {
+        new->zstd = ZSTD_createDStream();
+        if (new->zstd == NULL || ZSTD_isError(ZSTD_initDStream(new->zstd))) {
+            freeStreamADT(new);
+            return NULL;
+        }
+    }
+#endif
+    return new;
+}
+
+streamFormat getStreamFormat(const streamADT stream)
+{
+    return stream->format;
+}
+
+#if defined(MEDIA_GZIP) || defined(MEDIA_ZSTD)
+/**
+ * @brief Funcion auxiliar que vuelve a llenar el buffer de entrada si ya se consumio por completo.
+ *
+ * @return 1 si el buffer tiene datos o el archivo termino, 0 ante un error de lectura.
+ */
+static int fillInput(streamADT stream)
+{
+    if (stream->inputPos < stream->inputSize || stream->inputEnd)
+        return 1;
+    ssize_t n = readFile(stream->fd, stream->inputData, STREAM_BUFFER);
+    if (n == -1)
+        return 0;
+    stream->inputEnd = n == 0;
+    stream->inputSize = (size_t)n;
+    stream->inputPos = 0;
+    return 1;
+}
+#endif
+
+#ifdef MEDIA_GZIP
+/**
+ * @brief Funcion auxiliar que descomprime los siguientes bytes de un archivo gzip. Los miembros sucesivos se
+ * concatenan, como hace gunzip.
+ */
+static size_t gzipRead(streamADT stream, void * buffer, size_t len)
+{
+    z_stream * z = &stream->gzip;
+    unsigned space = len > UINT_MAX ? UINT_MAX : (unsigned)len;
+    z->next_out = buffer;
+    z->avail_out = space;
+    while (1) {
+        if (!fillInput(stream)) {
+            stream->failed = 1;
+            return 0;
+        }
+        size_t available = stream->inputSize - stream->inputPos;
+        z->next_in = stream->inputData + stream->inputPos;
+        z->avail_in = available > UINT_MAX ? UINT_MAX : (unsigned)available;
+        unsigned before = z->avail_in, pending = z->avail_out;
+        int result = inflate(z, Z_NO_FLUSH);
+        stream->inputPos += before - z->avail_in;
+        if (result == Z_STREAM_END) {
+            stream->frameEnd = 1;
+            inflateReset(z);
+        }
+        else if (result != Z_OK && result != Z_BUF_ERROR) {
+            stream->failed = 1;
+            return 0;
+        }
+        else if (z->avail_in != before || z->avail_out != pending)
+            stream->frameEnd = 0;
+        if (z->avail_out != space)
+            return space - z->avail_out;
+        /// Sin datos pendientes ni salida, el archivo termino; si el ultimo miembro no estaba completo, esta truncado.
+        if (stream->inputEnd && stream->inputPos == stream->inputSize) {
+            stream->failed = !stream->frameEnd;
+            return 0;
+        }
+    }
+}
+#endif
+
+#ifdef MEDIA_ZSTD
+/**
+ * @brief Funcion auxiliar que descomprime los siguientes bytes de un archivo zstd. Los frames sucesivos se
+ * concatenan, como hace zstd -d.
+ */
+static size_t zstdRead(streamADT stream, void * buffer, size_t len)
+{
+    ZSTD_outBuffer output = { buffer, len, 0 };
+    while (1) {
+        if (!fillInput(stream)) {
+            stream->failed = 1;
+            return 0;
+        }
+        ZSTD_inBuffer input = { stream->inputData, stream->inputSize, stream->inputPos };
+        size_t out = ZSTD_decompressStream(stream->zstd, &output, &input);
+        if (ZSTD_isError(out)) {
+            stream->failed = 1;
+            return 0;
+        }
+        /// Sin avanzar, el descompresor devuelve lo que espera del proximo frame, por lo que no se tiene en cuenta.
+        if (output.pos > 0 || input.pos != stream->inputPos)
+            stream->frameEnd = out == 0;
+        stream->inputPos = input.pos;
+        if (output.pos > 0)
+            return output.pos;
+        /// Sin datos pendientes ni salida, el archivo termino; si el ultimo frame no estaba completo, esta truncado.
+        if (stream->inputEnd && stream->inputPos == stream->inputSize) {
+            stream->failed = !stream->frameEnd;
+            return 0;
+        }
+    }
+}
+#endif
+
+size_t streamRead(streamADT stream, void * buffer, size_t len)
+{
+    if (stream->failed || len == 0)
+        return 0;
+#ifdef MEDIA_GZIP
+    if (stream->format == STREAM_GZIP)
+        return gzipRead(stream, buffer, len);
+#endif
+#ifdef MEDIA_ZSTD
+    if (stream->format == STREAM_ZSTD)
+        return zstdRead(stream, buffer, len);
+#endif
+    /// Primero se entregan los bytes leidos para determinar el formato.
+    if (stream->inputPos < stream->inputSize) {
+        size_t n = stream->inputSize - stream->inputPos;
+        n = n < len ? n : len;
+        memcpy(buffer, stream->inputData + stream->inputPos, n);
+        stream->inputPos += n;
+        return n;
+    }
+    ssize_t n = readFile(stream->fd, buffer, len);
+    if (n == -1) {
+        stream->failed = 1;
+        return 0;
+    }
+    return (size_t)n;
+}
+
+int streamError(const streamADT stream)
+{
+    return stream->failed;
+}
+
+void freeStreamADT(streamADT stream)
+{
+#ifdef MEDIA_GZIP
+    if (stream->gzipReady)
+        inflateEnd(&stream->gzip);
+#endif
+#ifdef MEDIA_ZSTD
+    ZSTD_freeDStream(stream->zstd);
+#endif
+    free(stream->inputData);
+    if (stream->fd != STDIN_FILENO)
+        close(stream->fd);
+    free(stream);
+}
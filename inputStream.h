@@ -0,0 +1,79 @@
+#ifndef TPEFINAL_INPUTSTREAM_H
+#define TPEFINAL_INPUTSTREAM_H
+
+#include <stdlib.h>
+
+#define STDIN_PATH "-"      /**< @def Ruta con la que se indica que se debe leer la entrada estandar */
+
+typedef struct streamCDT * streamADT;
+
+/**
+ * @brief Formatos de archivo de entrada, segun sus primeros bytes.
+ */
+typedef enum {
+    STREAM_PLAIN = 0,   /**< @enum Archivo sin comprimir                */
+    STREAM_GZIP,        /**< @enum Archivo comprimido con gzip (.gz)    */
+    STREAM_ZSTD         /**< @enum Archivo comprimido con zstd (.zst)   */
+} streamFormat;
+
+/**
+ * @brief Funcion que determina el formato de un archivo a partir de sus primeros bytes.
+ *
+ * @param filePath Archivo a examinar.
+ * @return Formato del archivo. Si no puede leerse se devuelve STREAM_PLAIN (el error se informa al abrirlo), al igual
+ * que para la entrada estandar (STDIN_PATH), cuyo formato solo se conoce al abrirla.
+ */
+streamFormat detectStreamFormat(const char * filePath);
+
+/**
+ * @brief Funcion que indica si se compilo el soporte para un formato.
+ *
+ * @details gzip requiere compilar con -DMEDIA_GZIP y zlib; zstd con -DMEDIA_ZSTD y libzstd.
+ *
+ * @param format Formato a consultar.
+ * @return 1 si el formato puede leerse, 0 si no.
+ */
+int isStreamFormatSupported(streamFormat format);
+
+/**
+ * @brief Funcion que abre un archivo para leerlo en orden, descomprimiendolo si es necesario.
+ *
+ * @param filePath Archivo a abrir, o STDIN_PATH para leer la entrada estandar.
+ * @return streamADT creado o NULL si no se pudo abrir el archivo, reservar memoria o su formato no es soportado.
+ * Si la entrada estandar tiene un formato no soportado se devuelve el streamADT con el error (ver streamError()).
+ */
+streamADT newStreamADT(const char * filePath);
+
+/**
+ * @brief Funcion que devuelve el formato del archivo abierto.
+ *
+ * @param stream Archivo abierto con newStreamADT().
+ */
+streamFormat getStreamFormat(const streamADT stream);
+
+/**
+ * @brief Funcion que lee los siguientes bytes (ya descomprimidos) del archivo.
+ *
+ * @param stream Archivo abierto con newStreamADT().
+ * @param buffer Destino de los bytes leidos.
+ * @param len Maxima cantidad de bytes a leer.
+ * @return Cantidad de bytes leidos (al menos 1 si len > 0), o 0 al llegar al final del archivo o ante un error.
+ */
+size_t streamRead(streamADT stream, void * buffer, size_t len);
+
+/**
+ * @brief Funcion que indica si se produjo un error de lectura o el contenido comprimido esta dañado o incompleto.
+ *
+ * @param stream Archivo abierto con newStreamADT().
+ * @return 1 si se produjo un error, 0 si no.
+ */
+int streamError(const streamADT stream);
+
+/**
+ * @brief Funcion que cierra el archivo y libera los recursos reservados.
+ *
+ * @param stream Archivo abierto con newStreamADT().
+ */
+void freeStreamADT(streamADT stream);
+
+#endif //TPEFINAL_INPUTSTREAM_H
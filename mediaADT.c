@@ -1,11 +1,54 @@
+#define _POSIX_C_SOURCE 200112L
 #include "mediaADT.h"
+#include "quantileSketch.h"
+#include "fenwickTree.h"
 #include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stddef.h>
 #include <string.h>
 #include <strings.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #define POS(Y,MIN) ((Y) - (MIN))            /**< @def Macro para obtener posicion en vector de punteros a TYear */
 #define YEAR(P,MIN) ((P) + (MIN))           /**< @def Macro para obtener el año a partir de un indice */
 #define IS_VALID_YEAR(Y,MIN) ((Y) >= (MIN)) /**< @def Macro que devuelve 1 si el año es valido para operar en el TAD o 0 si no lo es */
+#define YEAR_BLOCK 32                       /**< @def Capacidad inicial del vector de años */
+#define WORD_BITS 64                        /**< @def Cantidad de años por palabra del mapa de años ocupados */
+#define BITMAP_WORDS(N) (((N) + WORD_BITS - 1) / WORD_BITS) /**< @def Palabras del mapa para N posiciones */
+
+/** @def Acceso a la columna FIELD de un contenido del almacen central */
+#define COLUMN(M,ID,FIELD) ((M)->contentChunks[(ID) / MEM_BLOCK]->FIELD[(ID) % MEM_BLOCK])
+#define UNDEFINED_GENRE "\\N"                /**< @def Genero que indica que el contenido no tiene generos */
+#define UNIDENTIFIED_GENRE "Género no identificado" /**< @def Genero asignado al contenido sin generos */
+#define FIRST_ID_BLOCK 16                   /**< @def Capacidad del primer bloque de indices de un genero */
+#define GENRE_BLOCK 32                      /**< @def Capacidad inicial de la tabla de generos de un año y del diccionario */
+#define NO_GENRE ((TGenreId)-1)             /**< @def Identificador invalido de genero */
+#define NO_CONTENT ((TContentId)-1)         /**< @def Indice invalido del almacen central */
+#define KEY_BLOCK 1024                      /**< @def Capacidad inicial de la tabla de claves de contenidos */
+#define STATS_SAMPLE 32                     /**< @def Se mide el tiempo de insercion de una de cada STATS_SAMPLE filas */
+#define MAX_READERS 64                      /**< @def Maxima cantidad de lectores con una version fijada a la vez */
+/** @def Posicion del par de generos A > B en la matriz triangular de pares de un año (sin la diagonal) */
+#define PAIR_POS(A,B) ((size_t)(A) * ((A) - 1) / 2 + (B))
+#define PAIR_SLOTS(N) ((size_t)(N) * ((N) - 1))      /**< @def Cantidades de la matriz de N generos (dos por par) */
+
+#define REL_GET(FIELD) ((const char *)&(FIELD) + (FIELD))                          /**< @def Puntero indicado por un TRelPtr */
+#define REL_SET(FIELD,PTR) ((FIELD) = (TRelPtr)((intptr_t)(PTR) - (intptr_t)&(FIELD))) /**< @def Apunta un TRelPtr a PTR */
+#define GENRES_OF(M,ID) ((TGenreId *)(uintptr_t)REL_GET(COLUMN(M,ID,genres))) /**< @def Vector de generos de un contenido */
+
+#define SNAPSHOT_MAGIC "TPESNAP"             /**< @def Identificador de archivo de snapshot (8 bytes con el '\0') */
+#define SNAPSHOT_VERSION 11                  /**< @def Version del formato de snapshot */
+#define SNAPSHOT_ALIGN 8                     /**< @def Alineacion de cada seccion del snapshot */
+/** @def Huella de la disposicion en memoria de los structs guardados, para rechazar snapshots de otra arquitectura */
+#define SNAPSHOT_LAYOUT ((unsigned long)sizeof(TContentChunk) / MEM_BLOCK | (unsigned long)sizeof(struct year) << 8 | \
+                         (unsigned long)sizeof(TGenre) << 16 | (unsigned long)sizeof(TIdBlock) << 24 | \
+                         (unsigned long)sizeof(size_t) << 32 | (unsigned long)sizeof(TQuantileSketch) << 40)
 
 #define SUCCESS 100   /**< @def Constante numerica para indicar que una operacion se realizo exitosamente */
 
@@ -13,102 +56,532 @@
 #define CHECK_MEM(PTR) { if( (PTR) == NULL)   \
                             return MEM_ERROR; }
 
+#ifndef MEDIA_NO_STATS
+#define STATS_ADD(M,FIELD,N) ((M)->stats.FIELD += (N))  /**< @def Suma N a un contador de las estadisticas del TAD */
+#else
+#define STATS_ADD(M,FIELD,N) ((void)(N))                 /**< @def Sin estadisticas, N no se acumula             */
+#endif
+
+/**
+ * @brief Indice de una pelicula/serie dentro del almacen central de contenidos del TAD.
+ */
+typedef unsigned int TContentId;
+
+/**
+ * @brief Desplazamiento en bytes desde el propio campo hasta el dato apuntado. A diferencia de un puntero, sigue
+ * siendo valido si el registro que lo contiene se lee desde un snapshot mapeado en otra direccion.
+ */
+typedef long TRelPtr;
+
+/**
+ * @brief Identificador denso de un genero dentro del diccionario de generos del TAD.
+ */
+typedef unsigned int TGenreId;
+
+/**
+ * @brief Valores de una pelicula/serie que se copian al almacen central (sin titulo ni generos).
+ */
+typedef struct record {
+    unsigned long numVotes;           /**< Cantidad de votos                            */
+    float averageRating;              /**< Puntaje promedio                             */
+    unsigned short startYear;         /**< Año de comienzo                              */
+    unsigned short endYear;           /**< Año de finalizacion                          */
+    unsigned short runtimeMinutes;    /**< Duracion en minutos                          */
+    unsigned char type;               /**< CONTENTTYPE_MOVIE o CONTENTTYPE_SERIES        */
+    unsigned char genresCount;        /**< Cantidad de generos                          */
+} TRecord;
+
 /**
- *  @brief Struct para manejar películas y series en un genero determinado
+ * @brief Bloque de MEM_BLOCK contenidos del almacen central, guardados por columnas: cada campo numerico ocupa un
+ * vector contiguo, por lo que recorrer un campo solo lee ese campo (@see aggregateContent). Los titulos y los
+ * vectores de generos se guardan aparte en el arena y cada contenido los referencia con un TRelPtr.
+ */
+typedef struct contentChunk {
+    unsigned long numVotes[MEM_BLOCK];        /**< Cantidad de votos                            */
+    TRelPtr title[MEM_BLOCK];                 /**< Titulo original (terminado en '\0')          */
+    TRelPtr genres[MEM_BLOCK];                /**< Vector de identificadores de sus generos     */
+    float averageRating[MEM_BLOCK];           /**< Puntaje promedio                             */
+    unsigned short startYear[MEM_BLOCK];      /**< Año de comienzo                              */
+    unsigned short endYear[MEM_BLOCK];        /**< Año de finalizacion                          */
+    unsigned short runtimeMinutes[MEM_BLOCK]; /**< Duracion en minutos                          */
+    unsigned char type[MEM_BLOCK];            /**< CONTENTTYPE_MOVIE o CONTENTTYPE_SERIES        */
+    unsigned char genresCount[MEM_BLOCK];     /**< Cantidad de generos                          */
+} TContentChunk;
+
+/**
+ * @brief Bloque de indices de peliculas/series dentro de un genero. Los bloques se reservan en el arena del TAD
+ * duplicando su capacidad (hasta MEM_BLOCK) y se encadenan, por lo que nunca se mueven ni se copian al crecer.
+ */
+typedef struct idBlock {
+    struct idBlock * next;      /**< Bloque completado anteriormente                         */
+    size_t capacity;            /**< Cantidad maxima de indices                              */
+    size_t count;               /**< Cantidad de indices ocupados                            */
+    size_t shared;              /**< 1 si lo comparte una version publicada (@see freezeIds) */
+    TContentId ids[];           /**< Indices al almacen central                              */
+} TIdBlock;
+
+/**
+ * @brief Min-heap acotado con los indices de las peliculas/series mas votadas de un año o de un genero en un año.
+ *
+ * @details Tiene lugar para media->topK indices y la raiz es el peor de los guardados, por lo que cada contenido
+ * nuevo se compara solo con la raiz. Un contenido esta peor ubicado que otro si tiene menos votos o, con los mismos
+ * votos, si se añadio despues (mayor indice). Los contenidos sin votos no se guardan.
+ */
+typedef struct topHeap {
+    size_t count;               /**< Cantidad de indices guardados  */
+    TContentId ids[];           /**< Indices al almacen central     */
+} TTopHeap;
+
+/**
+ *  @brief Struct para manejar películas y series en un genero determinado, dentro de la tabla de un año.
  */
 typedef struct genre{
-    char genre[MAX_GENRE_SIZE]; /**< Nombre del genero                                     */
-    TContent * series;          /**< Vector que contiene las series añadidas               */
-    TContent * movies;          /**< Vector que contiene las peliculas añadidas            */
+    const char * name;          /**< Nombre del genero tal como se ingreso por primera vez en el año */
+    TIdBlock * series;          /**< Bloques de indices a las series añadidas              */
+    TIdBlock * movies;          /**< Bloques de indices a las peliculas añadidas           */
     size_t moviesCount;         /**< Cantidad de peliculas añadidas en el genero           */
     size_t seriesCount;         /**< Cantidad de series añadidas en el genero              */
-    struct genre * next;        /**< Puntero al siguiente struct genre (para formar lista) */
+    TTopHeap * topMovies;       /**< Peliculas mas votadas del genero en el año (o NULL)   */
+    TTopHeap * topSeries;       /**< Series mas votadas del genero en el año (o NULL)      */
+    TQuantileSketch * moviesSketch; /**< Puntajes y duraciones de las peliculas (o NULL)   */
+    TQuantileSketch * seriesSketch; /**< Puntajes y duraciones de las series (o NULL)      */
 } TGenre;
 
-typedef TGenre * TList;
+/**
+ * @brief Lista de las distintas formas de escribir un mismo genero (por ejemplo "Drama" y "drama").
+ */
+typedef struct spelling {
+    struct spelling * next;     /**< Siguiente forma de escribir el genero */
+    char name[];                /**< Genero tal como fue ingresado         */
+} TSpelling;
+
+/**
+ * @brief Diccionario de generos: asigna a cada genero (sin distinguir mayusculas) un identificador denso.
+ *
+ * @details Los nombres se buscan mediante una tabla de hash con direccionamiento abierto. El orden alfabetico se
+ * mantiene aparte como una permutacion de identificadores en la que cada genero nuevo se inserta al registrarlo, por
+ * lo que recorrer los generos no modifica el diccionario.
+ */
+typedef struct genreDict {
+    TSpelling ** names;         /**< Formas de escribir cada genero (la primera es la ingresada primero), por id   */
+    size_t count;               /**< Cantidad de generos registrados                                             */
+    TGenreId * table;           /**< Tabla de hash: guarda id + 1 (0 indica posicion libre)                       */
+    size_t tableSize;           /**< Cantidad de posiciones de la tabla (potencia de 2)                           */
+    TGenreId * order;           /**< Permutacion de ids en orden alfabetico                                       */
+} TGenreDict;
 
 /**
  * @brief Struct para manejar peliculas y series en un año determinado
  */
 struct year {
-    TList genres;              /**< Lista ordenada alfabeticamente por géneros de películas y series */
-    TContent bestMovie;        /**< Pelicula con mayor cantidad de votos en el año                   */
-    TContent bestSeries;       /**< Serie con mayor cantidad de votos en el año                      */
-    size_t bestMovieRating;    /**< Cantidad de votos de bestMovie                                   */
+    TGenre * genres;           /**< Tabla de generos del año indexada por identificador de genero    */
+    size_t genresSize;         /**< Cantidad de posiciones reservadas en la tabla de generos         */
+    TContentId bestMovie;      /**< Indice de la pelicula con mayor cantidad de votos en el año      */
+    TContentId bestSeries;     /**< Indice de la serie con mayor cantidad de votos en el año         */
+    size_t bestMovieRating;    /**< Cantidad de votos de bestMovie (0 si no hay pelicula con votos)  */
     size_t bestSeriesRating;   /**< Cantidad de votos de bestSeries                                  */
     size_t moviesCount;        /**< Cantidad de películas añadidas                                   */
     size_t seriesCount;        /**< Cantidad de series añadidas                                      */
+    TTopHeap * topMovies;      /**< Peliculas mas votadas del año (o NULL si no hay con votos)       */
+    TTopHeap * topSeries;      /**< Series mas votadas del año (o NULL si no hay con votos)          */
+    TQuantileSketch * moviesSketch; /**< Puntajes y duraciones de las peliculas del año (o NULL)     */
+    TQuantileSketch * seriesSketch; /**< Puntajes y duraciones de las series del año (o NULL)        */
+    size_t * pairs;            /**< Co-ocurrencias: peliculas y series de cada par de generos (@see PAIR_POS) */
+    size_t pairsGenres;        /**< Cantidad de generos que cubre la matriz "pairs"                  */
+    struct frozenYear * frozen; /**< Copia inmutable del año publicada en versiones (NULL si cambio desde entonces) */
 };
 
 typedef struct year * TYear;
 
+/**
+ * @brief Copia inmutable de un año, que comparten todas las versiones publicadas mientras el año no cambie.
+ *
+ * @details Se reserva en un unico bloque junto con su tabla de generos, sus heaps, sus sketches, su matriz de pares
+ * de generos y una copia del primer bloque de indices de cada genero si no estaba lleno (los bloques llenos ya no se
+ * modifican al añadir).
+ */
+typedef struct frozenYear {
+    size_t refs;                /**< Referencias: versiones que la utilizan, mas el año original si aun es valida */
+    struct year year;           /**< Copia del año                                                                */
+} TFrozenYear;
+
 /**
  * @brief TAD para el manejo de peliculas y series
  */
 typedef struct mediaCDT{
     TYear * years;              /**< Vector de punteros a TYear para guardar las películas y series por año             */
-    TList currentGenre;         /**< Iterador por genero                                                                */
-    size_t currentIndex;        /**< Iterador por años                                                                  */
+    TContentChunk ** contentChunks; /**< Almacen central por bloques de MEM_BLOCK: cada pelicula/serie se guarda una vez */
+    size_t contentsCount;       /**< Cantidad de peliculas/series guardadas en el almacen central                       */
+    size_t chunksCount;         /**< Cantidad de bloques reservados en contentChunks (los ultimos pueden estar vacios)  */
+    arenaADT arena;             /**< Arena del cual se toma la memoria de años, generos y contenidos                    */
+    int ownsArena;              /**< 1 si el arena fue creado por el TAD y debe liberarse junto con el mismo            */
+    TGenreDict dict;            /**< Diccionario de generos compartido por todos los años                               */
+    TYearCursor yearCursor;     /**< Iterador por años de toBeginYear()                                                 */
+    TGenreCursor genreCursor;   /**< Iterador por genero de toBeginGenre()                                              */
+    TTopCursor topCursor;       /**< Iterador de mas votadas de toBeginTop()                                            */
     size_t minYear;             /**< Año minimo de comienzo de pelicula/serie que aceptara el TAD para añadir contenido */
+    size_t baseYear;            /**< Año de la posicion 0 del vector de años (puede bajar hasta minYear)                */
     size_t dim;                 /**< Cantidad de años ocupados (es decir, que contienen al menos una película/serie)    */
-    size_t size;                /**< Cantidad total de años reservados en memoria                                       */
+    size_t size;                /**< Cantidad total de años reservados en memoria, desde baseYear                       */
+    unsigned long long * occupied; /**< Mapa de bits de los años ocupados: un bit por posicion del vector de años       */
+    TContentId * keyTable;      /**< Tabla de hash de contenidos por titulo, año y tipo: guarda id + 1 (0 si libre)    */
+    size_t keyTableSize;        /**< Cantidad de posiciones de keyTable (potencia de 2)                                 */
+    size_t keyedCount;          /**< Cantidad de contenidos (desde el primero) ya registrados en keyTable               */
+    TContentId * titleTable;    /**< Tabla de hash de contenidos por titulo: guarda id + 1 (0 si libre)                 */
+    size_t titleTableSize;      /**< Cantidad de posiciones de titleTable (potencia de 2)                               */
+    TContentId * titleOrder;    /**< Contenidos registrados en el indice de titulos, ordenados por titulo               */
+    size_t titledCount;         /**< Cantidad de contenidos (desde el primero) registrados en el indice de titulos      */
+    size_t topK;                /**< Capacidad de los heaps de mas votadas                                              */
+    mediaMode mode;             /**< MEDIA_FULL o MEDIA_AGGREGATE                                                       */
+    size_t * rangeTrees;        /**< Arboles de Fenwick de cantidades por año: por tipo, del total y de cada genero      */
+    size_t rangeYears;          /**< Cantidad de años que cubre cada arbol de rangeTrees                                */
+    size_t rangeGenres;         /**< Cantidad de generos que cubre rangeTrees                                           */
+    void * mapping;             /**< Snapshot mapeado en memoria del cual se leen los datos (NULL si no hay)            */
+    size_t mappingSize;         /**< Tamaño del snapshot mapeado                                                        */
+    struct mediaCDT * current;  /**< Ultima version publicada (NULL si no se publico ninguna)                           */
+    struct mediaCDT * retired;  /**< Versiones reemplazadas que aun pueden estar fijadas por lectores                   */
+    unsigned long long * sharedChunks; /**< Mapa de bits de los bloques de contenidos que comparten las versiones       */
+    size_t sharedContents;      /**< Contenidos que existian al publicar: las versiones comparten su vector de generos  */
+    unsigned long epoch;        /**< Epoca actual: aumenta cada vez que se reemplaza una version                        */
+    unsigned long readers[MAX_READERS]; /**< Epoca anunciada por cada lector con una version fijada (0 si libre)        */
+    struct mediaCDT * nextRetired; /**< Siguiente version de la lista "retired" (solo versiones)                        */
+    unsigned long retiredEpoch; /**< Epoca en la que se reemplazo la version (solo versiones)                           */
+    TMediaStats stats;          /**< Contadores de getMediaStats() (los campos del arena solo de los TAD combinados)    */
+    size_t statsTick;           /**< Filas añadidas desde la creacion, para medir el tiempo de una de cada STATS_SAMPLE */
 } mediaCDT;
 
-mediaADT newMediaADT (const size_t minYear)
+/**
+ * @brief Encabezado de un snapshot. Todos los desplazamientos son relativos al comienzo del archivo.
+ *
+ * @details Luego del encabezado, el archivo contiene: la tabla de desplazamientos de cada año (0 si esta vacio); cada
+ * struct year seguido de su tabla de generos, sus heaps de mas votadas, sus sketches de cuantiles y su matriz de pares
+ * de generos, y el nombre, un unico bloque de indices, los heaps y los sketches de cada genero; la tabla de
+ * desplazamientos de las formas de escribir cada genero del diccionario; los bloques de columnas del almacen central;
+ * los generos y el titulo de cada contenido y por ultimo, en modo MEDIA_FULL, la tabla de claves de contenidos. Los
+ * punteros de los structs year y genre se guardan como desplazamientos y se traducen al cargar (una cantidad de años x
+ * generos, independiente de la cantidad de contenidos); los titulos y generos de los contenidos son TRelPtr, por lo que
+ * se leen sin modificar.
+ */
+typedef struct snapshotHeader {
+    char magic[8];                /**< SNAPSHOT_MAGIC                                             */
+    unsigned long version;        /**< SNAPSHOT_VERSION                                           */
+    unsigned long layout;         /**< SNAPSHOT_LAYOUT                                            */
+    unsigned long checksum;       /**< Suma de verificacion de todo lo que sigue al encabezado    */
+    unsigned long fileSize;       /**< Tamaño total del archivo                                   */
+    unsigned long minYear;        /**< Año minimo del TAD                                         */
+    unsigned long baseYear;       /**< Año de la posicion 0 de la tabla de años                   */
+    unsigned long size;           /**< Cantidad de años reservados                                */
+    unsigned long dim;            /**< Cantidad de años ocupados                                  */
+    unsigned long contentsCount;  /**< Cantidad de registros                                      */
+    unsigned long genresCount;    /**< Cantidad de generos del diccionario                        */
+    unsigned long yearsOffset;    /**< Tabla de desplazamientos de cada año                        */
+    unsigned long dictOffset;     /**< Tabla de desplazamientos de cada genero del diccionario     */
+    unsigned long recordsOffset;  /**< Registros del almacen central                              */
+    unsigned long topK;           /**< Capacidad de los heaps de mas votadas                      */
+    unsigned long mode;           /**< Modo del TAD (mediaMode)                                   */
+    unsigned long keysOffset;     /**< Tabla de claves de contenidos (titulo, año y tipo)         */
+    unsigned long keysSize;       /**< Cantidad de posiciones de la tabla de claves (0 si no hay) */
+} TSnapshotHeader;
+
+/**
+ * @brief Escritor de snapshots en dos pasadas: con "base" en NULL solo se calculan los desplazamientos (y el tamaño
+ * total); con "base" apuntando al archivo mapeado se copian los datos.
+ */
+typedef struct snapshotWriter {
+    char * base;                  /**< Comienzo del archivo mapeado (NULL en la primera pasada)   */
+    size_t pos;                   /**< Proxima posicion libre                                     */
+} TSnapshotWriter;
+
+/**
+ * @brief Fila valida de un lote de addContentBatch().
+ */
+typedef struct batchRow {
+    size_t genres;                /**< Posicion de sus generos en los vectores de generos del lote */
+    size_t next;                  /**< Siguiente fila valida del mismo año (la cantidad de filas si no hay) */
+    TContentId id;                /**< Indice en el almacen central                                */
+} TBatchRow;
+
+/**
+ * @brief Genero tal como aparece en las filas de un lote, con su identificador en el diccionario.
+ */
+typedef struct batchGenre {
+    TSlice name;                  /**< Genero (str en NULL si la posicion esta libre)              */
+    TGenreId id;                  /**< Identificador en el diccionario                             */
+} TBatchGenre;
+
+/**
+ * @brief Tabla de hash de los generos de un lote: cada forma de escribir un genero se busca en el diccionario una
+ * unica vez por lote (@see addContentBatch).
+ */
+typedef struct batchGenres {
+    TBatchGenre * table;          /**< Posiciones de la tabla                                      */
+    size_t size;                  /**< Cantidad de posiciones (potencia de 2, o 0 si esta vacia)   */
+    size_t count;                 /**< Cantidad de posiciones ocupadas                             */
+} TBatchGenres;
+
+/**
+ * @brief Funcion auxiliar que devuelve el instante actual en nanosegundos, para medir las fases del TAD.
+ *
+ * @return Nanosegundos desde un instante fijo, o 0 si el TAD se compilo sin estadisticas.
+ */
+static unsigned long long statsNow(void){
+#ifndef MEDIA_NO_STATS
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ull + (unsigned long long)now.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+mediaADT newMediaADT (const size_t minYear, arenaADT arena, const mediaMode mode)
 {
     mediaADT new = calloc(1,sizeof (mediaCDT));
-    /// Se setean los extremos del vector dinamico. Inicialmente el extremo superior es igual al inferior.
+    if (new == NULL)
+        return NULL;
+    /// Si el usuario no indica un arena, el TAD crea uno propio y se encarga de liberarlo.
+    if (arena == NULL) {
+        if ((arena = newArenaADT(0)) == NULL) {
+            free(new);
+            return NULL;
+        }
+        new->ownsArena = 1;
+    }
+    new->arena = arena;
+    /// El vector de años se reserva con el primer año añadido y luego crece hacia ambos extremos.
     new->minYear = minYear;
+    new->topK = DEFAULT_TOP_K;
+    new->mode = mode;
+    new->epoch = 1;
     return new;
 }
 
+mediaMode getMediaMode(const mediaADT media){
+    return media->mode;
+}
+
+int setTopK(mediaADT media, const size_t k){
+    /// Los heaps ya reservados tienen lugar para el K anterior, por lo que solo se admite antes de añadir contenido.
+    if (k < 1 || k > MAX_TOP_K || media->contentsCount > 0)
+        return RANGE_ERROR;
+    media->topK = k;
+    return 1;
+}
+
+size_t getTopK(const mediaADT media){
+    return media->topK;
+}
+
+/**
+ * @brief Funcion auxiliar que reserva los bloques del almacen central necesarios para guardar "count" registros mas,
+ * agrandando la tabla de punteros a bloques una unica vez.
+ *
+ * @return 1 si se reservaron correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int reserveStore(mediaADT media, const size_t count){
+    size_t chunks = (media->contentsCount + count + MEM_BLOCK - 1) / MEM_BLOCK;
+    if (chunks <= media->chunksCount)
+        return 1;
+    TContentChunk ** aux = realloc(media->contentChunks, sizeof(TContentChunk *) * chunks);
+    CHECK_MEM(aux);
+    media->contentChunks = aux;
+    STATS_ADD(media, tableGrowths, 1);
+    STATS_ADD(media, tableGrowthBytes, sizeof(TContentChunk *) * chunks);
+    for (; media->chunksCount < chunks; media->chunksCount++)
+        CHECK_MEM(media->contentChunks[media->chunksCount] = arenaAlloc(media->arena, sizeof(TContentChunk)));
+    return 1;
+}
+
 /**
- * @brief Funcion auxiliar que copia en un vector una pelicula/serie.
+ * @brief Funcion auxiliar que copia un registro al final del almacen central.
+ *
+ * @details El almacen se divide en bloques de MEM_BLOCK registros tomados del arena, por lo que los registros ya
+ * guardados nunca se mueven. Solo la tabla de punteros a bloques crece mediante realloc (un puntero cada MEM_BLOCK
+ * registros). El titulo y los generos son lo unico que se copia del texto de entrada, en una unica reserva.
  *
- * @details Se reserva memoria a bloques para evitar reallocs cada vez que se ejecute la funcion. A su vez, se le permite
- * al usuario elegir si desea un bloque mas grande o mas chico mediante MEM_BLOCK. De esta forma, si se añade una gran cantidad de
- * peliculas y series no se incrementara el tiempo de ejecucion en gran manera.
- * Al finalizar la carga, algunas posiciones del vector podrian quedar vacias. En este caso, se priorizo tiempo de ejecucion
- * sobre memoria debido a que podria haber una gran carga de datos.
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param record Valores a copiar.
+ * @param source Titulo del registro. No necesita terminar en '\0'.
+ * @param titleLen Longitud del titulo del registro.
+ * @param genres Identificadores de los generos del registro (record->genresCount).
+ * @return 1 si se copio correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int storeRecord(mediaADT media, const TRecord * record, const char * source, const size_t titleLen,
+                       const TGenreId * genres){
+    size_t id = media->contentsCount;
+    /// Si el indice llega al final del ultimo bloque y no hay uno reservado (@see reserveStore), se reserva uno nuevo.
+    if (id % MEM_BLOCK == 0 && id / MEM_BLOCK == media->chunksCount && reserveStore(media, 1) == MEM_ERROR)
+        return MEM_ERROR;
+    TGenreId * auxGenres = arenaAlloc(media->arena, sizeof(TGenreId) * record->genresCount + titleLen + 1);
+    CHECK_MEM(auxGenres);
+    memcpy(auxGenres, genres, sizeof(TGenreId) * record->genresCount);
+    char * title = (char *)(auxGenres + record->genresCount);
+    memcpy(title, source, titleLen);
+    title[titleLen] = '\0';
+
+    COLUMN(media, id, numVotes) = record->numVotes;
+    COLUMN(media, id, averageRating) = record->averageRating;
+    COLUMN(media, id, startYear) = record->startYear;
+    COLUMN(media, id, endYear) = record->endYear;
+    COLUMN(media, id, runtimeMinutes) = record->runtimeMinutes;
+    COLUMN(media, id, type) = record->type;
+    COLUMN(media, id, genresCount) = record->genresCount;
+    REL_SET(COLUMN(media, id, title), title);
+    REL_SET(COLUMN(media, id, genres), auxGenres);
+    media->contentsCount++;
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve los valores de una fila de entrada que se guardan en el almacen central.
+ */
+static TRecord rawRecord(const TRawContent * content){
+    TRecord record;
+    record.numVotes = content->numVotes;
+    record.averageRating = content->averageRating;
+    record.startYear = content->startYear;
+    record.endYear = content->endYear;
+    record.runtimeMinutes = content->runtimeMinutes;
+    record.type = content->type;
+    record.genresCount = content->genresCount;
+    return record;
+}
+
+/**
+ * @brief Funcion auxiliar que copia una fila de entrada al final del almacen central.
  *
- * @param contentVec Vector de tipo TContent en el que sera copiado al final la nueva película/serie.
+ * @param media ADT creado para el manejo de peliculas/series.
  * @param content Pelicula/serie que sera copiada.
- * @param index Indice del vector en el que sera copiado la pelicula/serie.
- * @return Puntero al comienzo del vector.
- */
-static TContent * copyStruct(TContent * contentVec, const TContent content, const size_t index){
-    /// Si el indice llega al bloque de memoria, se expandirá el vector
-    if (index % MEM_BLOCK == 0){
-        contentVec = realloc(contentVec, sizeof(TContent)*(index + MEM_BLOCK));
-        if ( contentVec == NULL){
+ * @param genres Identificadores de los generos de la pelicula/serie (content->genresCount).
+ * @return 1 si se copio correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int storeContent(mediaADT media, const TRawContent * content, const TGenreId * genres){
+    TRecord record = rawRecord(content);
+    return storeRecord(media, &record, content->primaryTitle.str, content->primaryTitle.len, genres);
+}
+
+/**
+ * @brief Funcion auxiliar que lee los valores de un contenido del almacen central.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param id Indice del contenido.
+ * @return Valores del contenido.
+ */
+static TRecord loadRecord(const mediaADT media, const TContentId id){
+    TRecord record;
+    record.numVotes = COLUMN(media, id, numVotes);
+    record.averageRating = COLUMN(media, id, averageRating);
+    record.startYear = COLUMN(media, id, startYear);
+    record.endYear = COLUMN(media, id, endYear);
+    record.runtimeMinutes = COLUMN(media, id, runtimeMinutes);
+    record.type = COLUMN(media, id, type);
+    record.genresCount = COLUMN(media, id, genresCount);
+    return record;
+}
+
+/**
+ * @brief Funcion auxiliar que arma un TContent a partir de un contenido del almacen central.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param id Indice del contenido.
+ * @return TContent con los datos del contenido (el vector de generos no se conserva y queda en NULL).
+ */
+static TContent recordToContent(const mediaADT media, const TContentId id){
+    TContent content = {{0}};
+    strcpy(content.titleType, COLUMN(media, id, type) == CONTENTTYPE_MOVIE ? "movie" : "tvSeries");
+    strncpy(content.primaryTitle, REL_GET(COLUMN(media, id, title)), MAX_TITLE_SIZE - 1);
+    content.startYear = COLUMN(media, id, startYear);
+    content.endYear = COLUMN(media, id, endYear);
+    content.runtimeMinutes = COLUMN(media, id, runtimeMinutes);
+    content.numVotes = COLUMN(media, id, numVotes);
+    content.averageRating = COLUMN(media, id, averageRating);
+    return content;
+}
+
+/**
+ * @brief Funcion auxiliar que añade el indice de una pelicula/serie al primer bloque de una lista de bloques.
+ *
+ * @details Si el bloque actual esta lleno, se toma del arena uno nuevo con el doble de capacidad (hasta MEM_BLOCK).
+ *
+ * @param arena Arena del cual se toma la memoria.
+ * @param first Primer bloque de la lista (el unico que puede tener lugar libre).
+ * @param id Indice de la pelicula/serie en el almacen central.
+ * @return Primer bloque de la lista o NULL si se produjo un error de memoria.
+ */
+static TIdBlock * appendId(arenaADT arena, TIdBlock * first, const TContentId id){
+    if (first == NULL || first->count == first->capacity){
+        size_t capacity = first == NULL ? FIRST_ID_BLOCK : first->capacity * 2;
+        if (capacity > MEM_BLOCK)
+            capacity = MEM_BLOCK;
+        TIdBlock * new = arenaAlloc(arena, sizeof(TIdBlock) + capacity * sizeof(TContentId));
+        if (new == NULL)
             return NULL;
-        }
+        new->capacity = capacity;
+        new->next = first;
+        first = new;
+    }
+    first->ids[first->count++] = id;
+    return first;
+}
+
+/**
+ * @brief Funcion auxiliar que asegura lugar para "count" indices mas en el primer bloque de una lista, para que las
+ * filas de un lote se añadan sin encadenar varios bloques (@see addContentBatch).
+ *
+ * @details Si no alcanza, se reserva un bloque con lugar para todos (al menos la capacidad que usaria appendId()).
+ * Solo el primer bloque de una lista puede tener lugar libre, por lo que si no estaba lleno sus indices pasan al
+ * nuevo (un bloque con lugar libre nunca se comparte con las versiones publicadas, @see freezeIds).
+ *
+ * @param arena Arena del cual se toma la memoria.
+ * @param first Puntero al primer bloque de la lista, que se actualiza si se reserva uno nuevo.
+ * @param count Cantidad de indices a añadir.
+ * @return 1 si hay lugar o MEM_ERROR si se produjo un error de memoria.
+ */
+static int reserveIds(arenaADT arena, TIdBlock ** first, const size_t count){
+    TIdBlock * old = *first;
+    if (count == 0 || (old != NULL && old->capacity - old->count >= count))
+        return 1;
+    size_t used = old == NULL || old->count == old->capacity ? 0 : old->count;
+    size_t capacity = old == NULL ? FIRST_ID_BLOCK : old->capacity * 2;
+    if (capacity > MEM_BLOCK)
+        capacity = MEM_BLOCK;
+    if (capacity < used + count)
+        capacity = used + count;
+    TIdBlock * new = arenaAlloc(arena, sizeof(TIdBlock) + capacity * sizeof(TContentId));
+    CHECK_MEM(new);
+    new->capacity = capacity;
+    new->next = old;
+    if (used > 0){
+        memcpy(new->ids, old->ids, used * sizeof(TContentId));
+        new->count = used;
+        new->next = old->next;
     }
-    contentVec[index]=content;
-    return contentVec;
+    *first = new;
+    return 1;
 }
 
 /**
- * @brief Funcion auxiliar que añade pelicula/serie dentro de un genero, actualizando struct genre para reflejar el
- * contenido añadido.
+ * @brief Funcion auxiliar que añade una referencia a una pelicula/serie dentro de un genero, actualizando struct genre
+ * para reflejar el contenido añadido.
  *
- * @param genre Puntero a struct genre (TList)
- * @param content Pelicula/serie que será añadida.
+ * @param arena Arena del cual se toma la memoria.
+ * @param genre Puntero a struct genre
+ * @param id Indice de la pelicula/serie en el almacen central.
  * @param title Indica si el contenido a añadir es una película o una serie.
  * @return CONTENTTYPE_MOVIE si fue añadida una película.
  * @return CONTENTTYPE_SERIES si fue añadida una serie.
  * @return MEM_ERROR si se produjo un error de memoria.
  */
-static int copyContent(TList genre, const TContent content, const contentType title){
-    /// Evalua si es una pelicula o una serie y llama a copyStruct
+static int copyContent(arenaADT arena, TGenre * genre, const TContentId id, const contentType title){
+    /// Evalua si es una pelicula o una serie y llama a appendId
     if (title == CONTENTTYPE_MOVIE){
-        if ( (genre->movies= copyStruct(genre->movies, content, genre->moviesCount)) != NULL) {
+        if ( (genre->movies= appendId(arena, genre->movies, id)) != NULL) {
             genre->moviesCount++;
             return CONTENTTYPE_MOVIE;
         }
     }
     else{
-        if ( (genre->series = copyStruct(genre->series, content, genre->seriesCount)) != NULL){
+        if ( (genre->series = appendId(arena, genre->series, id)) != NULL){
             genre->seriesCount++;
             return CONTENTTYPE_SERIES;
         }
@@ -117,319 +590,3135 @@ static int copyContent(TList genre, const TContent content, const contentType ti
 }
 
 /**
- * @brief Funcion auxiliar recursiva que añade película/serie en un mediaADT en un año y genero determinado.
- *
- * @param listG Puntero a struct genre (TList) que contiene las peliculas/series añadidas dentro de un genero en
- * especifico, junto a la cantidad añadida de las mismas.
- * @param content Pelicula/serie que sera añadida.
- * @param genre Genero de la pelicula/serie.
- * @param title Indica si el contenido a añadir es una pelicula o una serie.
- * @param flag Al finalizar la ejecución de la función apuntará a MEM_ERROR si hubo un error de asignacion de memoria,
- * CONTENTTYPE_MOVIE si fue añadida una pelicula o CONTENTTYPE_SERIES si fue añadida una serie.
- * @return Puntero a struct genre (TList) al ser una funcion recursiva.
+ * @brief Funcion auxiliar que indica si el contenido "a" esta peor ubicado que "b" entre los mas votados: tiene menos
+ * votos o, con los mismos votos, se añadio despues.
  */
-static TList addContentByGenre_Rec(TList listG, const TContent content, const char * genre, const contentType title, int * flag) {
-    int c;
-    if (listG == NULL || (c = strcasecmp(genre, listG->genre)) < 0) {
-        TList newGenre = calloc(1, sizeof(TGenre)); /// Si el genero no existia, se crea un nuevo nodo.
-        if (newGenre == NULL) {
-            *flag = MEM_ERROR;
-            return NULL;
-        }
-        strcpy(newGenre->genre, genre);
-        *flag = copyContent(newGenre, content, title);
-        newGenre->next = listG;
-        return newGenre;
-
-    } else if (c == 0) {                                  /// Si el genero existia, llama directamente a addContent
-        *flag = copyContent(listG, content, title);
-        return listG;
-    }
-    listG->next = addContentByGenre_Rec(listG->next, content, genre, title, flag);
-    return listG;
+static int ranksBelow(const mediaADT media, const TContentId a, const TContentId b){
+    unsigned long votesA = COLUMN(media, a, numVotes), votesB = COLUMN(media, b, numVotes);
+    return votesA < votesB || (votesA == votesB && a > b);
 }
 
 /**
- * @brief Funcion auxiliar que indica mediante distintas constantes si un año es "valido" o no con respecto a un mediaADT.
- *
- * @param media ADT creado para el manejo de peliculas/series.
- * @param year Año que sera evaluado.
- * @return INVALIDYEAR_ERROR si el año es menor al año mínimo indicado en el mediaADT.
- * @return MEM_ERROR si el año es mayor a la memoria que fue asignada en el mediaADT.
- * @return SUCCESS si no se cumple ninguna de las 2 condiciones mencionadas anteriormente.
+ * @brief Funcion auxiliar que baja la posicion "pos" de un heap hasta recuperar el orden (la raiz es el peor).
  */
-static int isYearValid (mediaADT media , const unsigned short year)
-{
-    if (!IS_VALID_YEAR(year, media->minYear))
-        return INVALIDYEAR_ERROR;
-    if ( year > YEAR(media->size-1,media->minYear))
-        return MEM_ERROR;
-    return SUCCESS;
-}
-
-int addContent( mediaADT media , const TContent content , const unsigned short year , char ** genre , const unsigned long numVotes , const contentType title){
-    int c;
-    /// Se valida si el año pasado como parametro es válido dentro del mediaADT
-    if ( (c=isYearValid(media, year)) == INVALIDYEAR_ERROR){
-        return INVALIDYEAR_ERROR;
-    }
-
-    /// Se valida si el contenido a añadir es una pelicula o serie
-    if ( title != CONTENTTYPE_MOVIE && title != CONTENTTYPE_SERIES){
-        return CONTENTTYPE_ERROR;
-    }
-    int index= POS(year, media->minYear);
-
-    /// Si es la primera vez que se añade una pelicula/serie, o el año pasado como parametro es mayor al que puede
-    /// acceder el vector de años en el ADT (no se puede acceder al indice), se reserva memoria para los años y se
-    /// inicializa con ceros los campos de bestMovieRating, bestSeriesRating, moviesCount y seriesCount para los mismos
-    if ( media->size == 0 || c == MEM_ERROR){
-        media->years=realloc(media->years, sizeof(TYear)*(index+1));
-        CHECK_MEM(media->years);
-        memset(media->years + media->size, 0, (index - media->size + 1) * sizeof (TYear));
-        media->size= index+1;
+static void siftDown(const mediaADT media, TTopHeap * heap, size_t pos){
+    while (1){
+        size_t worst = pos, left = 2 * pos + 1, right = left + 1;
+        if (left < heap->count && ranksBelow(media, heap->ids[left], heap->ids[worst]))
+            worst = left;
+        if (right < heap->count && ranksBelow(media, heap->ids[right], heap->ids[worst]))
+            worst = right;
+        if (worst == pos)
+            return;
+        TContentId aux = heap->ids[pos];
+        heap->ids[pos] = heap->ids[worst];
+        heap->ids[worst] = aux;
+        pos = worst;
     }
+}
 
-    /// Si no fue añadida una pelicula/serie en el año, se reserva espacio.
-    /// Luego de la carga de todas las series y peliculas, podrian quedar posiciones vacias dentro del vector years.
-    /// En este caso, se priorizo tiempo de ejecucion sobre memoria debido a que podria haber una gran carga de datos.
-    if (media->years[index] == NULL){
-        media->years[index]= calloc(1, sizeof(struct year));
-        CHECK_MEM(media->years[index]);
-        media->dim++;
+/**
+ * @brief Funcion auxiliar que sube la posicion "pos" de un heap hasta recuperar el orden.
+ */
+static void siftUp(const mediaADT media, TTopHeap * heap, size_t pos){
+    while (pos > 0 && ranksBelow(media, heap->ids[pos], heap->ids[(pos - 1) / 2])){
+        TContentId aux = heap->ids[pos];
+        heap->ids[pos] = heap->ids[(pos - 1) / 2];
+        heap->ids[(pos - 1) / 2] = aux;
+        pos = (pos - 1) / 2;
     }
-    int flag;
+}
 
-    /// Se añade la película/serie en sus generos correspondientes
-    for ( int i=0; genre[i] != NULL; i++) {
-        media->years[index]->genres = addContentByGenre_Rec(media->years[index]->genres, content, genre[i], title, &flag);
-        if (flag == MEM_ERROR){
-            return MEM_ERROR;
-        }
-    }
+/**
+ * @brief Funcion auxiliar que devuelve la posicion de un indice dentro de un heap, o heap->count si no esta.
+ */
+static size_t heapFind(const TTopHeap * heap, const TContentId id){
+    size_t i = 0;
+    while (i < heap->count && heap->ids[i] != id)
+        i++;
+    return i;
+}
 
-    /// Se actualiza la cantidad de películas/series añadidas. A pesar de que la misma película/serie se añadio a varios
-    /// generos (si es que tiene mas de uno), se contabilizara una sola vez. Ademas, se actualiza la mejor serie/pelicula
-    /// con su cantidad de votos.
-    if ( title == CONTENTTYPE_MOVIE){
-        (media->years[index]->moviesCount)++;
-        if ( numVotes > media->years[index]->bestMovieRating){
-            media->years[index]->bestMovieRating = numVotes;
-            media->years[index]->bestMovie = content;
-        }
+/**
+ * @brief Funcion auxiliar que ofrece un contenido a un heap de mas votadas: se guarda si hay lugar o si supera al
+ * peor de los guardados (que se descarta). El heap se reserva en el arena la primera vez.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param heap Puntero al heap, que se actualiza si se reserva.
+ * @param id Indice del contenido. Si ya estaba en el heap, no se vuelve a guardar.
+ * @return 1 si se ofrecio correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int offerTop(mediaADT media, TTopHeap ** heap, const TContentId id){
+    if (COLUMN(media, id, numVotes) == 0)
+        return 1;
+    if (*heap == NULL)
+        CHECK_MEM(*heap = arenaAlloc(media->arena, sizeof(TTopHeap) + sizeof(TContentId) * media->topK));
+    TTopHeap * aux = *heap;
+    if (aux->count == media->topK && !ranksBelow(media, aux->ids[0], id))
+        return 1;
+    if (heapFind(aux, id) < aux->count)
+        return 1;
+    if (aux->count < media->topK){
+        aux->ids[aux->count++] = id;
+        siftUp(media, aux, aux->count - 1);
     }
     else {
-        (media->years[index]->seriesCount++);
-        if (numVotes > media->years[index]->bestSeriesRating){
-            media->years[index]->bestSeriesRating= numVotes;
-            media->years[index]->bestSeries = content;
-        }
+        aux->ids[0] = id;
+        siftDown(media, aux, 0);
     }
-
     return 1;
 }
 
-size_t countContentByYear(const mediaADT media, const unsigned short year, contentType CONTENTTYPE_ )
-{
-    if (isYearValid(media, year) != SUCCESS )
-        return 0;
-
-    size_t aux;
-    switch (CONTENTTYPE_) {
-        case CONTENTTYPE_MOVIE:
-            aux = media->years[POS(year, media->minYear)]->moviesCount;
-            break;
-        case CONTENTTYPE_SERIES:
-            aux = media->years[POS(year, media->minYear)]->seriesCount;
-            break;
-        default:
-            break;
-    }
-    return aux;
+/**
+ * @brief Funcion auxiliar que ofrece a un heap todos los indices de una lista de bloques.
+ */
+static int offerIds(mediaADT media, TTopHeap ** heap, const TIdBlock * block){
+    for (; block != NULL; block = block->next)
+        for (size_t i = 0; i < block->count; i++)
+            if (offerTop(media, heap, block->ids[i]) == MEM_ERROR)
+                return MEM_ERROR;
+    return 1;
 }
 
 /**
- * @brief Función auxiliar para buscar un genero en la lista de generos
+ * @brief Funcion auxiliar que añade el puntaje y la duracion de un contenido a un sketch de cuantiles, que se reserva
+ * en el arena la primera vez.
  *
- * @param first Puntero al primer genero de la lista
- * @param genre Genero a buscar en la lista
- * @return NULL si el genero no esta en la lista.
- * @return Puntero al nodo si esta en la lista.
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param sketch Puntero al sketch, que se actualiza si se reserva.
+ * @param id Indice del contenido.
+ * @return 1 si se añadio correctamente o MEM_ERROR si se produjo un error de memoria.
  */
-static TList searchGenre ( const TList first , const char * genre )
-{
-    int c;
-    if ( first == NULL || (c = strcasecmp(first->genre,genre) ) > 0 )
-        return NULL;       /// Como los generos están ordenados alfabéticamente, deja de buscar si se "paso"
-    if ( c == 0 )
-        return first;
-    return searchGenre(first->next , genre);
+static int sketchContent(mediaADT media, TQuantileSketch ** sketch, const TContentId id){
+    if (*sketch == NULL)
+        CHECK_MEM(*sketch = arenaAlloc(media->arena, sizeof(TQuantileSketch)));
+    sketchAdd(*sketch, COLUMN(media, id, averageRating), COLUMN(media, id, runtimeMinutes));
+    return 1;
 }
 
-size_t countContentByGenre(const mediaADT media, const unsigned short year, const char * genre ,  contentType CONTENTTYPE_ )
-{
-    if (isYearValid(media, year) != SUCCESS)
-        return 0;
-
-    TList auxGenre = searchGenre(media->years[POS(year, media->minYear)]->genres , genre );
-    if ( auxGenre == NULL )
-        return 0;
-
-    size_t aux;
-    switch (CONTENTTYPE_) {
-        case CONTENTTYPE_MOVIE:
-            aux = auxGenre->moviesCount;
-            break;
-        case CONTENTTYPE_SERIES:
-            aux = auxGenre->seriesCount;
-            break;
-        default:
-            break;
-    }
-
-    return aux;
+/**
+ * @brief Funcion auxiliar que acumula un sketch de otro TAD en un sketch del TAD destino.
+ */
+static int mergeSketch(mediaADT media, TQuantileSketch ** sketch, const TQuantileSketch * from){
+    if (from == NULL)
+        return 1;
+    if (*sketch == NULL)
+        CHECK_MEM(*sketch = arenaAlloc(media->arena, sizeof(TQuantileSketch)));
+    sketchMerge(*sketch, from);
+    return 1;
 }
 
-TContent mostVoted(const mediaADT media, const unsigned short year, const contentType CONTENTTYPE_){
-
-    /**
-     * Se crea un struct vacío, el cual la función retornará en caso de error
-     *
-     * @see mediaADT.h
-     */
-    TContent mostVotedContent  = {0};
+/**
+ * @brief Funcion auxiliar de hash (FNV-1a) sobre un genero sin distinguir mayusculas de minusculas.
+ *
+ * @param genre Genero a hashear.
+ * @return Valor de hash.
+ */
+static size_t hashGenre(const TSlice genre){
+    size_t h = 2166136261u;
+    for (size_t i = 0; i < genre.len; i++)
+        h = (h ^ (unsigned char)tolower((unsigned char)genre.str[i])) * 16777619u;
+    return h;
+}
 
-    /// Se verifica si el año es valido
-    if (isYearValid(media, year) != SUCCESS)
-        return mostVotedContent;
+/**
+ * @brief Funcion auxiliar que compara un nombre guardado con un genero sin terminar en '\0'.
+ *
+ * @param name Nombre guardado.
+ * @param genre Genero a comparar.
+ * @param ignoreCase 1 si no deben distinguirse mayusculas de minusculas.
+ * @return 1 si son iguales.
+ */
+static int sameGenre(const char * name, const TSlice genre, const int ignoreCase){
+    int c = ignoreCase ? strncasecmp(name, genre.str, genre.len) : strncmp(name, genre.str, genre.len);
+    return c == 0 && name[genre.len] == '\0';
+}
 
-    /// Se verifica de que tipo de contenido se desea obtener el más votado
-    switch (CONTENTTYPE_) {
-        case CONTENTTYPE_MOVIE:
-            mostVotedContent = media->years[POS(year,media->minYear)]->bestMovie;
-            break;
-        case CONTENTTYPE_SERIES:
-            mostVotedContent = media->years[POS(year, media->minYear)]->bestSeries;
-            break;
-        default:
-            break;
+/**
+ * @brief Funcion auxiliar que busca la posicion de un genero en la tabla de hash del diccionario.
+ *
+ * @param dict Diccionario de generos.
+ * @param genre Genero a buscar.
+ * @param probes Contador al que se suman las posiciones visitadas (o NULL).
+ * @return Posicion de la tabla que contiene al genero, o la posicion libre donde deberia insertarse.
+ */
+static size_t probeGenre(const TGenreDict * dict, const TSlice genre, size_t * probes){
+    size_t mask = dict->tableSize - 1;
+    size_t i = hashGenre(genre) & mask;
+    size_t visited = 1;
+    while (dict->table[i] != 0 && !sameGenre(dict->names[dict->table[i] - 1]->name, genre, 1)){
+        i = (i + 1) & mask;
+        visited++;
     }
+    if (probes != NULL)
+        *probes += visited;
+    return i;
+}
 
-    return mostVotedContent;
+/**
+ * @brief Funcion auxiliar que devuelve el identificador de un genero sin registrarlo.
+ *
+ * @param dict Diccionario de generos.
+ * @param genre Genero a buscar.
+ * @return Identificador del genero o NO_GENRE si no fue registrado.
+ */
+static TGenreId findGenre(const TGenreDict * dict, const TSlice genre){
+    if (dict->tableSize == 0)
+        return NO_GENRE;
+    TGenreId aux = dict->table[probeGenre(dict, genre, NULL)];
+    return aux == 0 ? NO_GENRE : aux - 1;
 }
 
 /**
- * @brief Funcion auxiliar de iterador que coloca al currentIndex en el siguiente año ocupado/valido.
+ * @brief Funcion auxiliar que duplica la tabla de hash del diccionario y reubica los generos registrados.
  *
- * @param ADT creado para el manejo de peliculas/series.
- * @param fromIndex Indice desde donde se comienza a buscar el siguiente año ocupado.
+ * @param dict Diccionario de generos.
+ * @return 1 si se pudo agrandar la tabla o MEM_ERROR si se produjo un error de memoria.
  */
-static void nextOcuppiedYear(const mediaADT media, const size_t fromIndex) {
-    for (size_t i = fromIndex; i > 0; --i) {
-        /// Si el año encontrado no está vacio, setea el indice del iterador a la posición del mismo
-        if (media->years[i] != NULL) {
-            media->currentIndex = i;
-            return;
-        }
+static int growGenreTable(TGenreDict * dict){
+    size_t oldSize = dict->tableSize;
+    TGenreId * old = dict->table;
+    dict->tableSize = oldSize == 0 ? GENRE_BLOCK * 2 : oldSize * 2;
+    dict->table = calloc(dict->tableSize, sizeof(TGenreId));
+    if (dict->table == NULL){
+        dict->table = old;
+        dict->tableSize = oldSize;
+        return MEM_ERROR;
     }
-    media->currentIndex = media->size;
+    for (size_t i = 0; i < oldSize; i++)
+        if (old[i] != 0){
+            TSlice name = { dict->names[old[i] - 1]->name, strlen(dict->names[old[i] - 1]->name) };
+            dict->table[probeGenre(dict, name, NULL)] = old[i];
+        }
+    free(old);
+    return 1;
 }
 
-void toBeginYear(const mediaADT media){
-    /// Se busca el siguiente año valido.
-    nextOcuppiedYear(media, media->size - 1);
+/**
+ * @brief Funcion auxiliar que crea un nodo de TSpelling en el arena.
+ *
+ * @param arena Arena del cual se toma la memoria.
+ * @param genre Genero tal como fue ingresado.
+ * @return Nodo creado o NULL si se produjo un error de memoria.
+ */
+static TSpelling * newSpelling(arenaADT arena, const TSlice genre){
+    TSpelling * new = arenaAlloc(arena, sizeof(TSpelling) + genre.len + 1);
+    if (new != NULL)
+        memcpy(new->name, genre.str, genre.len);
+    return new;
 }
 
-int hasNextYear(const mediaADT media){
-    /// La iteración se realizará siempre y cuando se esté dentro del rango correspondiente
-    return media->currentIndex < media->size;
+/**
+ * @brief Funcion auxiliar que devuelve la forma de escribir un genero registrado, agregandola si no existia.
+ *
+ * @details Se utiliza solo la primera vez que un genero aparece en un año, para conservar el nombre tal como se
+ * ingreso en ese año.
+ *
+ * @param arena Arena del cual se toma la memoria.
+ * @param dict Diccionario de generos.
+ * @param id Identificador del genero.
+ * @param genre Genero tal como fue ingresado.
+ * @return Nombre guardado o NULL si se produjo un error de memoria.
+ */
+static const char * genreSpelling(arenaADT arena, TGenreDict * dict, const TGenreId id, const TSlice genre){
+    TSpelling * aux = dict->names[id];
+    while (!sameGenre(aux->name, genre, 0)){
+        if (aux->next == NULL && (aux->next = newSpelling(arena, genre)) == NULL)
+            return NULL;
+        aux = aux->next;
+    }
+    return aux->name;
 }
 
-unsigned short nextYear(const mediaADT media){
-
-    /**
-     * Si no quedan años validos por recorrer, la función devuelve RANGE_ERROR. El cual podrá ser manejado
-     * desde el frontend.
-     *
-     * @see mediaADT.h
-     */
+/**
+ * @brief Funcion auxiliar que devuelve el identificador de un genero, registrandolo si no existia en el diccionario
+ * del TAD.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param genre Genero a registrar.
+ * @return Identificador del genero o NO_GENRE si se produjo un error de memoria.
+ */
+static TGenreId internGenre(mediaADT media, const TSlice genre){
+    TGenreDict * dict = &media->dict;
+    /// Se mantiene el factor de carga de la tabla por debajo del 50%
+    if ((dict->count + 1) * 2 > dict->tableSize){
+        if (growGenreTable(dict) == MEM_ERROR)
+            return NO_GENRE;
+        STATS_ADD(media, tableGrowths, 1);
+        STATS_ADD(media, tableGrowthBytes, sizeof(TGenreId) * dict->tableSize);
+    }
+    size_t probes = 0;
+    size_t pos = probeGenre(dict, genre, &probes);
+    STATS_ADD(media, genreLookups, 1);
+    STATS_ADD(media, genreProbes, probes);
+    if (dict->table[pos] != 0)
+        return dict->table[pos] - 1;
 
-    if (!hasNextYear(media)){
-        return RANGE_ERROR;
+    if (dict->count % GENRE_BLOCK == 0){
+        TSpelling ** aux = realloc(dict->names, sizeof(TSpelling *) * (dict->count + GENRE_BLOCK));
+        if (aux == NULL)
+            return NO_GENRE;
+        dict->names = aux;
+        TGenreId * auxOrder = realloc(dict->order, sizeof(TGenreId) * (dict->count + GENRE_BLOCK));
+        if (auxOrder == NULL)
+            return NO_GENRE;
+        dict->order = auxOrder;
+        STATS_ADD(media, tableGrowths, 2);
+        STATS_ADD(media, tableGrowthBytes, (sizeof(TSpelling *) + sizeof(TGenreId)) * (dict->count + GENRE_BLOCK));
     }
+    TSpelling * name = newSpelling(media->arena, genre);
+    if (name == NULL)
+        return NO_GENRE;
+    dict->names[dict->count] = name;
 
-    /// Se obtiene el año actual
-    unsigned short year = YEAR(media->currentIndex, media->minYear);
+    /// El nuevo genero se inserta en la permutacion alfabetica mediante busqueda binaria.
+    size_t low = 0, high = dict->count;
+    while (low < high){
+        size_t mid = (low + high) / 2;
+        if (strcasecmp(dict->names[dict->order[mid]]->name, name->name) < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    memmove(dict->order + low + 1, dict->order + low, sizeof(TGenreId) * (dict->count - low));
+    dict->order[low] = dict->count;
+    dict->table[pos] = ++dict->count;
+    return dict->count - 1;
+}
 
-    ///Se busca el siguiente año valido desde la posicion actual
-    nextOcuppiedYear(media, media->currentIndex - 1);
-    return year;
+/**
+ * @brief Funcion auxiliar que devuelve el struct genre de un año para un identificador de genero, agrandando la
+ * tabla del año si el identificador todavia no entra en la misma.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año en el que se busca el genero.
+ * @param id Identificador del genero.
+ * @return Puntero al struct genre o NULL si se produjo un error de memoria.
+ */
+static TGenre * yearGenre(mediaADT media, TYear year, const TGenreId id){
+    if (id >= year->genresSize){
+        size_t size = year->genresSize == 0 ? GENRE_BLOCK : year->genresSize;
+        while (size <= id)
+            size *= 2;
+        /// La tabla anterior queda en el arena; las tablas son chicas y crecen pocas veces.
+        TGenre * aux = arenaAlloc(media->arena, sizeof(TGenre) * size);
+        if (aux == NULL)
+            return NULL;
+        if (year->genresSize > 0)
+            memcpy(aux, year->genres, sizeof(TGenre) * year->genresSize);
+        year->genres = aux;
+        year->genresSize = size;
+        STATS_ADD(media, tableGrowths, 1);
+        STATS_ADD(media, tableGrowthBytes, sizeof(TGenre) * size);
+    }
+    return &year->genres[id];
 }
 
-int toBeginGenre (const mediaADT media , const unsigned short year )
+/**
+ * @brief Funcion auxiliar que indica mediante distintas constantes si un año es "valido" o no con respecto a un mediaADT.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año que sera evaluado.
+ * @return INVALIDYEAR_ERROR si el año es menor al año mínimo indicado en el mediaADT.
+ * @return MEM_ERROR si el año esta fuera de la memoria que fue asignada en el mediaADT.
+ * @return SUCCESS si no se cumple ninguna de las 2 condiciones mencionadas anteriormente.
+ */
+static int isYearValid (mediaADT media , const unsigned short year)
 {
-    /// Se verifica que el año sea valido
-    if (isYearValid(media,year) != SUCCESS )
+    if (!IS_VALID_YEAR(year, media->minYear))
         return INVALIDYEAR_ERROR;
+    if ( year < media->baseYear || POS(year, media->baseYear) >= media->size )
+        return MEM_ERROR;
+    return SUCCESS;
+}
 
-    TYear aux = media->years[POS(year,media->minYear)];
-    /// Se verifica que el año pedido tenga contenido
-    CHECK_MEM(aux)
+/**
+ * @brief Funcion auxiliar que libera una referencia a la copia inmutable de un año.
+ */
+static void releaseFrozen(TFrozenYear * frozen){
+    if (frozen != NULL && --frozen->refs == 0)
+        free(frozen);
+}
+
+/**
+ * @brief Funcion auxiliar que indica que un año va a modificarse: su copia inmutable deja de representarlo (las
+ * versiones ya publicadas la conservan) y la proxima publicacion lo vuelve a copiar.
+ */
+static void touchYear(TYear year){
+    releaseFrozen(year->frozen);
+    year->frozen = NULL;
+}
+
+/**
+ * @brief Funcion auxiliar que reserva en el almacen central los registros de la pelicula y la serie mas votadas de
+ * un año nuevo, en modo MEDIA_AGGREGATE. Cada titulo tiene lugar para MAX_TITLE_SIZE caracteres, por lo que los
+ * registros se sobrescriben en el lugar (@see offerBest).
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año nuevo.
+ * @param startYear Año de comienzo que representa "year".
+ * @return 1 si se reservaron correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int reserveBest(mediaADT media, TYear year, const unsigned short startYear){
+    static const char noTitle[MAX_TITLE_SIZE];
+    TRecord record = {0};
+    record.startYear = startYear;
+    TGenreId noGenre = 0;
+    year->bestMovie = media->contentsCount;
+    record.type = CONTENTTYPE_MOVIE;
+    if (storeRecord(media, &record, noTitle, MAX_TITLE_SIZE - 1, &noGenre) == MEM_ERROR)
+        return MEM_ERROR;
+    year->bestSeries = media->contentsCount;
+    record.type = CONTENTTYPE_SERIES;
+    return storeRecord(media, &record, noTitle, MAX_TITLE_SIZE - 1, &noGenre);
+}
 
-    media->currentGenre = aux->genres;
+/**
+ * @brief Funcion auxiliar que, en modo MEDIA_AGGREGATE, copia una pelicula/serie sobre el registro de la mas votada
+ * de su año si tiene mas votos (ante igual cantidad se conserva la anterior, como en el modo MEDIA_FULL).
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año de la pelicula/serie.
+ * @param record Valores de la pelicula/serie.
+ * @param title Titulo de la pelicula/serie. Se conservan a lo sumo MAX_TITLE_SIZE - 1 caracteres, como en mostVoted().
+ */
+static void offerBest(mediaADT media, TYear year, const TRecord * record, const TSlice title){
+    int isMovie = record->type == CONTENTTYPE_MOVIE;
+    size_t * bestVotes = isMovie ? &year->bestMovieRating : &year->bestSeriesRating;
+    if (record->numVotes <= *bestVotes)
+        return;
+    TContentId id = isMovie ? year->bestMovie : year->bestSeries;
+    *bestVotes = record->numVotes;
+    COLUMN(media, id, numVotes) = record->numVotes;
+    COLUMN(media, id, averageRating) = record->averageRating;
+    COLUMN(media, id, endYear) = record->endYear;
+    COLUMN(media, id, runtimeMinutes) = record->runtimeMinutes;
+    char * dest = (char *)(uintptr_t)REL_GET(COLUMN(media, id, title));
+    size_t len = title.len < MAX_TITLE_SIZE - 1 ? title.len : MAX_TITLE_SIZE - 1;
+    memcpy(dest, title.str, len);
+    dest[len] = '\0';
+}
+
+int addContent( mediaADT media , const TContent content , const unsigned short year , char ** genre , const unsigned long numVotes , const contentType title){
+    /// Se arma un TRawContent cuyos campos de texto apuntan a los del usuario, sin copiarlos.
+    TRawContent raw;
+    raw.primaryTitle.str = content.primaryTitle;
+    raw.primaryTitle.len = strlen(content.primaryTitle);
+    raw.genresCount = 0;
+    for ( int i=0; genre[i] != NULL && raw.genresCount < MAX_GENRES; i++) {
+        raw.genres[raw.genresCount].str = genre[i];
+        raw.genres[raw.genresCount++].len = strlen(genre[i]);
+    }
+    raw.startYear = year;
+    raw.endYear = content.endYear;
+    raw.runtimeMinutes = content.runtimeMinutes;
+    raw.numVotes = numVotes;
+    raw.averageRating = content.averageRating;
+    raw.type = title;
+    return addRawContent(media, &raw);
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve el identificador de un genero de un lote, buscandolo en el diccionario solo la
+ * primera vez que aparece escrito de esa forma en el lote.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param cache Generos ya resueltos del lote.
+ * @param genre Genero a resolver.
+ * @return Identificador del genero o NO_GENRE si se produjo un error de memoria.
+ */
+static TGenreId batchGenre(mediaADT media, TBatchGenres * cache, const TSlice genre){
+    /// Se mantiene el factor de carga de la tabla por debajo del 50%
+    if ((cache->count + 1) * 2 > cache->size){
+        size_t size = cache->size == 0 ? GENRE_BLOCK : cache->size * 2;
+        TBatchGenre * table = calloc(size, sizeof(TBatchGenre));
+        if (table == NULL)
+            return NO_GENRE;
+        for (size_t i = 0; i < cache->size; i++)
+            if (cache->table[i].name.str != NULL){
+                size_t pos = hashGenre(cache->table[i].name) & (size - 1);
+                while (table[pos].name.str != NULL)
+                    pos = (pos + 1) & (size - 1);
+                table[pos] = cache->table[i];
+            }
+        free(cache->table);
+        cache->table = table;
+        cache->size = size;
+    }
+    size_t pos = hashGenre(genre) & (cache->size - 1);
+    for (; cache->table[pos].name.str != NULL; pos = (pos + 1) & (cache->size - 1))
+        if (cache->table[pos].name.len == genre.len && memcmp(cache->table[pos].name.str, genre.str, genre.len) == 0)
+            return cache->table[pos].id;
+    TGenreId id = internGenre(media, genre);
+    if (id != NO_GENRE){
+        cache->table[pos].name = genre;
+        cache->table[pos].id = id;
+        cache->count++;
+    }
+    return id;
+}
+
+/**
+ * @brief Funcion auxiliar que resuelve los generos de una fila a sus identificadores, registrando los nuevos en el
+ * diccionario. El genero "\\N" se reemplaza por UNIDENTIFIED_GENRE.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param content Fila de entrada.
+ * @param names Vector donde se guardan los generos tal como se añadiran (content->genresCount posiciones).
+ * @param ids Vector donde se guardan los identificadores de los generos (content->genresCount posiciones).
+ * @param cache Generos ya resueltos del lote de la fila (@see batchGenre), o NULL si la fila no es parte de un lote.
+ * @return 1 si se resolvieron correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int internRowGenres(mediaADT media, const TRawContent * content, TSlice * names, TGenreId * ids,
+                           TBatchGenres * cache){
+    for ( size_t i=0; i < content->genresCount; i++) {
+        names[i] = content->genres[i];
+        if (names[i].len == strlen(UNDEFINED_GENRE) && strncmp(names[i].str, UNDEFINED_GENRE, names[i].len) == 0){
+            names[i].str = UNIDENTIFIED_GENRE;
+            names[i].len = strlen(UNIDENTIFIED_GENRE);
+        }
+        ids[i] = cache == NULL ? internGenre(media, names[i]) : batchGenre(media, cache, names[i]);
+        if (ids[i] == NO_GENRE)
+            return MEM_ERROR;
+    }
     return 1;
 }
 
-int hasNextGenre ( const mediaADT media )
-{
-    return media->currentGenre != NULL;
+/**
+ * @brief Funcion auxiliar que devuelve el arbol de Fenwick de cantidades por año de un tipo de contenido, para el
+ * total de cada año (genre en NO_GENRE) o para un genero.
+ */
+static size_t * rangeTree(const mediaADT media, const TGenreId genre, const contentType type){
+    size_t row = genre == NO_GENRE ? 0 : (size_t)genre + 1;
+    return media->rangeTrees + (row * 2 + (type - CONTENTTYPE_MOVIE)) * (media->rangeYears + 1);
 }
 
-char * nextGenre ( const mediaADT media )
-{
-    if ( !hasNextGenre(media) )
+/**
+ * @brief Funcion auxiliar que vuelve a armar los arboles de cantidades por año a partir de las cantidades de cada año
+ * y genero, duplicando su capacidad hasta cubrir todos los años y generos del TAD.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @return 1 si se armaron correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int rebuildRanges(mediaADT media){
+    size_t years = media->rangeYears == 0 ? 1 : media->rangeYears;
+    while (years < media->size)
+        years *= 2;
+    size_t genres = media->rangeGenres == 0 ? GENRE_BLOCK : media->rangeGenres;
+    while (genres < media->dict.count)
+        genres *= 2;
+    size_t * trees = calloc((genres + 1) * 2 * (years + 1), sizeof(size_t));
+    CHECK_MEM(trees);
+    STATS_ADD(media, tableGrowths, 1);
+    STATS_ADD(media, tableGrowthBytes, (genres + 1) * 2 * (years + 1) * sizeof(size_t));
+    free(media->rangeTrees);
+    media->rangeTrees = trees;
+    media->rangeYears = years;
+    media->rangeGenres = genres;
+
+    /// Se cargan las cantidades de cada año (desde la posicion 1) y luego se arma cada arbol en el lugar.
+    for (size_t i = 0; i < media->size; i++){
+        TYear year = media->years[i];
+        if (year == NULL)
+            continue;
+        rangeTree(media, NO_GENRE, CONTENTTYPE_MOVIE)[i + 1] = year->moviesCount;
+        rangeTree(media, NO_GENRE, CONTENTTYPE_SERIES)[i + 1] = year->seriesCount;
+        for (TGenreId j = 0; j < year->genresSize; j++){
+            if (year->genres[j].name == NULL)
+                continue;
+            rangeTree(media, j, CONTENTTYPE_MOVIE)[i + 1] = year->genres[j].moviesCount;
+            rangeTree(media, j, CONTENTTYPE_SERIES)[i + 1] = year->genres[j].seriesCount;
+        }
+    }
+    for (size_t i = 0; i < (genres + 1) * 2; i++)
+        fenwickBuild(media->rangeTrees + i * (years + 1), years);
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que registra en los arboles de cantidades por año un cambio en la cantidad de peliculas o
+ * series de un año (genre en NO_GENRE) o de un genero en un año.
+ *
+ * @details Debe llamarse luego de actualizar la cantidad del año o genero: si no entra en los arboles, estos se
+ * vuelven a armar a partir de las cantidades, que ya incluyen el cambio.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param index Posicion del año en el vector de años.
+ * @param genre Identificador del genero o NO_GENRE para el total del año.
+ * @param type Tipo del contenido.
+ * @param delta Cantidad añadida ((size_t)-k si se quitaron k).
+ * @return 1 si se registro correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int countRange(mediaADT media, const size_t index, const TGenreId genre, const contentType type,
+                      const size_t delta){
+    if (index >= media->rangeYears || (genre != NO_GENRE && genre >= media->rangeGenres))
+        return rebuildRanges(media);
+    fenwickAdd(rangeTree(media, genre, type), media->rangeYears, index, delta);
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que agranda el vector de años para que incluya un año, al menos duplicando su capacidad.
+ *
+ * @details Si el año es anterior al primero del vector, los años reservados se desplazan hacia el final y los arboles
+ * de cantidades por año se vuelven a armar, ya que cambian sus posiciones. Al duplicar la capacidad, ambos casos
+ * ocurren una cantidad logaritmica de veces.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año mayor o igual al año minimo del TAD, fuera del vector de años.
+ * @return 1 si se agrando correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int growYears(mediaADT media, const unsigned short year){
+    size_t base = media->baseYear, size = media->size;
+    size_t newSize = size == 0 ? YEAR_BLOCK : size * 2;
+    size_t newBase = base;
+    if (size == 0)
+        newBase = year;
+    else if (year < base){
+        /// Se conserva el ultimo año reservado y el vector se extiende hacia atras, sin bajar del año minimo.
+        if (newSize < base + size - year)
+            newSize = base + size - year;
+        newBase = base + size >= newSize + media->minYear ? base + size - newSize : media->minYear;
+    }
+    else if (newSize < POS(year, base) + 1)
+        newSize = POS(year, base) + 1;
+
+    TYear * years = realloc(media->years, sizeof(TYear) * newSize);
+    CHECK_MEM(years);
+    media->years = years;
+    unsigned long long * occupied = realloc(media->occupied, sizeof(unsigned long long) * BITMAP_WORDS(newSize));
+    CHECK_MEM(occupied);
+    media->occupied = occupied;
+    STATS_ADD(media, tableGrowths, 1);
+    STATS_ADD(media, tableGrowthBytes, sizeof(TYear) * newSize + sizeof(unsigned long long) * BITMAP_WORDS(newSize));
+
+    size_t shift = size == 0 ? 0 : base - newBase;
+    memmove(years + shift, years, sizeof(TYear) * size);
+    memset(years, 0, sizeof(TYear) * shift);
+    memset(years + shift + size, 0, sizeof(TYear) * (newSize - shift - size));
+    media->baseYear = newBase;
+    media->size = newSize;
+
+    /// El mapa se vuelve a armar desde el vector, lo que cuesta lo mismo que desplazarlo.
+    memset(occupied, 0, sizeof(unsigned long long) * BITMAP_WORDS(newSize));
+    for (size_t i = shift; i < shift + size; i++)
+        if (years[i] != NULL)
+            occupied[i / WORD_BITS] |= 1ull << (i % WORD_BITS);
+    if (shift > 0 && media->rangeTrees != NULL)
+        return rebuildRanges(media);
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve el struct year de un año valido, reservandolo si todavia no existia.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año mayor o igual al año minimo del TAD.
+ * @return Puntero al struct year o NULL si se produjo un error de memoria. Como el vector de años puede desplazarse,
+ * la posicion del año debe calcularse luego de reservarlo.
+ */
+static TYear reserveYear(mediaADT media, const unsigned short year){
+    /// Si el año esta fuera del vector (en cualquiera de sus extremos), se agranda.
+    if ((media->size == 0 || year < media->baseYear || POS(year, media->baseYear) >= media->size) &&
+        growYears(media, year) == MEM_ERROR)
         return NULL;
-    char * aux = media->currentGenre->genre;
-    media->currentGenre = media->currentGenre->next;
-    return aux;
+    size_t index = POS(year, media->baseYear);
+
+    /// Si no fue añadida una pelicula/serie en el año, se reserva espacio y se marca como ocupado.
+    /// Luego de la carga de todas las series y peliculas, podrian quedar posiciones vacias dentro del vector years.
+    /// En este caso, se priorizo tiempo de ejecucion sobre memoria debido a que podria haber una gran carga de datos.
+    if (media->years[index] == NULL){
+        if ((media->years[index]= arenaAlloc(media->arena, sizeof(struct year))) == NULL)
+            return NULL;
+        media->dim++;
+        media->occupied[index / WORD_BITS] |= 1ull << (index % WORD_BITS);
+        if (media->mode == MEDIA_AGGREGATE && reserveBest(media, media->years[index], year) == MEM_ERROR)
+            return NULL;
+    }
+    touchYear(media->years[index]);
+    return media->years[index];
 }
 
 /**
- * @brief Funcion auxiliar que libera los recursos reservados por una lista de structs genre.
+ * @brief Funcion auxiliar que añade el indice de una pelicula/serie a un genero de un año. Si es la primera vez que
+ * el genero aparece en el año, se conserva el nombre tal como fue ingresado.
  *
- * @param genre Puntero a struct genre (TList) que contiene las peliculas/series añadidas dentro de un género en
- * específico, junto a la cantidad añadida de las mismas.
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año de la pelicula/serie.
+ * @param genreId Identificador del genero.
+ * @param name Genero tal como fue ingresado.
+ * @param id Indice de la pelicula/serie en el almacen central.
+ * @param title Indica si el contenido es una película o una serie.
+ * @return 1 si se añadio correctamente o MEM_ERROR si se produjo un error de memoria.
  */
-static void freeGenres_Rec(TList genre){
-    if ( genre == NULL){
-        return;
+static int addToGenre(mediaADT media, TYear year, const TGenreId genreId, const TSlice name, const TContentId id,
+                      const contentType title){
+    TGenre * auxGenre = yearGenre(media, year, genreId);
+    CHECK_MEM(auxGenre);
+    if (auxGenre->name == NULL)
+        CHECK_MEM(auxGenre->name = genreSpelling(media->arena, &media->dict, genreId, name));
+    if (copyContent(media->arena, auxGenre, id, title) == MEM_ERROR ||
+        sketchContent(media, title == CONTENTTYPE_MOVIE ? &auxGenre->moviesSketch : &auxGenre->seriesSketch, id) == MEM_ERROR)
+        return MEM_ERROR;
+    return offerTop(media, title == CONTENTTYPE_MOVIE ? &auxGenre->topMovies : &auxGenre->topSeries, id);
+}
+
+/**
+ * @brief Funcion auxiliar que agranda la matriz de pares de generos de un año, si es necesario, para que cubra el
+ * identificador "id".
+ *
+ * @details La matriz guarda el triangulo inferior por filas, por lo que al agrandarla las cantidades ya registradas
+ * conservan su posicion y solo se copian al principio de la nueva.
+ *
+ * @return 1 si la matriz alcanza o MEM_ERROR si se produjo un error de memoria.
+ */
+static int yearPairs(mediaADT media, TYear year, const TGenreId id){
+    if (id < year->pairsGenres)
+        return 1;
+    size_t size = year->pairsGenres == 0 ? GENRE_BLOCK : year->pairsGenres;
+    while (size <= id)
+        size *= 2;
+    /// La matriz anterior queda en el arena, al igual que las tablas de generos.
+    size_t * aux = arenaAlloc(media->arena, sizeof(size_t) * PAIR_SLOTS(size));
+    CHECK_MEM(aux);
+    if (year->pairsGenres > 0)
+        memcpy(aux, year->pairs, sizeof(size_t) * PAIR_SLOTS(year->pairsGenres));
+    year->pairs = aux;
+    year->pairsGenres = size;
+    STATS_ADD(media, tableGrowths, 1);
+    STATS_ADD(media, tableGrowthBytes, sizeof(size_t) * PAIR_SLOTS(size));
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que suma "delta" a cada par de generos distintos de una pelicula/serie en la matriz de
+ * pares de su año, con un costo de O(k²) para k generos. Un genero repetido en la fila se cuenta una sola vez.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año de la pelicula/serie.
+ * @param genreIds Identificadores de sus generos.
+ * @param count Cantidad de generos.
+ * @param type Tipo de la pelicula/serie.
+ * @param delta Cantidad a sumar (con aritmetica modular, (size_t)-1 resta uno).
+ * @return 1 si se registraron correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int countPairs(mediaADT media, TYear year, const TGenreId * genreIds, const size_t count,
+                      const contentType type, const size_t delta){
+    /// Los identificadores se ordenan de menor a mayor sin repetidos, por lo que cada par queda como (mayor, menor).
+    TGenreId ids[MAX_GENRES];
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++){
+        size_t j = n;
+        while (j > 0 && ids[j - 1] > genreIds[i])
+            j--;
+        if (j > 0 && ids[j - 1] == genreIds[i])
+            continue;
+        memmove(ids + j + 1, ids + j, sizeof(TGenreId) * (n - j));
+        ids[j] = genreIds[i];
+        n++;
     }
-    freeGenres_Rec(genre->next);
-    free(genre->movies);
-    free(genre->series);
-    free(genre);
+    if (n < 2)
+        return 1;
+    if (yearPairs(media, year, ids[n - 1]) == MEM_ERROR)
+        return MEM_ERROR;
+    for (size_t i = 1; i < n; i++)
+        for (size_t j = 0; j < i; j++)
+            year->pairs[2 * PAIR_POS(ids[i], ids[j]) + (type - CONTENTTYPE_MOVIE)] += delta;
+    return 1;
 }
 
 /**
- * @brief Funcion auxiliar que libera los recursos reservados por struct year y su puntero.
+ * @brief Funcion auxiliar que registra en las estadisticas el resultado de añadir o corregir una fila.
  *
- * @param year Puntero a struct year que contiene las peliculas/series añadidas a mediaADT con comienzo en un año
- * determinado.
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param status Resultado de la operacion.
+ * @param added Contador de filas a incrementar si la operacion fue exitosa.
+ * @return status.
  */
-static void freeYear(TYear year){
-    freeGenres_Rec(year->genres);
-    free(year);
+static int countRow(mediaADT media, const int status, size_t * added){
+#ifndef MEDIA_NO_STATS
+    if (status == 1)
+        (*added)++;
+#else
+    (void)added;
+#endif
+    STATS_ADD(media, rowsRejected, status == CONTENTTYPE_ERROR);
+    STATS_ADD(media, rowsInvalidYear, status == INVALIDYEAR_ERROR);
+    return status;
 }
 
-void freeMediaADT(mediaADT media){
-    if ( media->size == 0){
-        return;
+/**
+ * @brief Funcion auxiliar que agranda los arboles de cantidades por año, si es necesario, para que cubran todos los
+ * años reservados y todos los generos del diccionario.
+ *
+ * @details Se llama antes de actualizar las cantidades de una o varias filas: asi countRange() no vuelve a armar los
+ * arboles a mitad de camino (con parte de los cambios ya incluidos) y cada cambio se registra una unica vez.
+ *
+ * @return 1 si los arboles alcanzan o MEM_ERROR si se produjo un error de memoria.
+ */
+static int reserveRanges(mediaADT media){
+    if (media->rangeYears < media->size || media->rangeGenres < media->dict.count)
+        return rebuildRanges(media);
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que ubica una fila ya validada en su año y en cada uno de sus generos, sin registrar los
+ * cambios en los arboles de cantidades por año (@see countRange).
+ *
+ * @details En modo MEDIA_FULL se añade su indice a los generos, los heaps de mas votadas y los sketches, y se
+ * actualizan las cantidades y la mas votada del año. En modo MEDIA_AGGREGATE solo se actualizan las cantidades y la
+ * copia de la mas votada del año. En ambos modos se registran sus pares de generos (@see countPairs).
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año (ya reservado) de la pelicula/serie.
+ * @param content Fila a añadir.
+ * @param names Generos tal como se añadiran (content->genresCount posiciones).
+ * @param genreIds Identificadores de los generos.
+ * @param id Indice de la pelicula/serie en el almacen central (solo en modo MEDIA_FULL).
+ * @return 1 si se añadio correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int placeContent(mediaADT media, TYear year, const TRawContent * content, const TSlice * names,
+                        const TGenreId * genreIds, const TContentId id){
+    const contentType title = content->type;
+    if (countPairs(media, year, genreIds, content->genresCount, title, 1) == MEM_ERROR)
+        return MEM_ERROR;
+    if (media->mode == MEDIA_AGGREGATE){
+        for (size_t i = 0; i < content->genresCount; i++){
+            TGenre * genre = yearGenre(media, year, genreIds[i]);
+            CHECK_MEM(genre);
+            if (genre->name == NULL)
+                CHECK_MEM(genre->name = genreSpelling(media->arena, &media->dict, genreIds[i], names[i]));
+            if (title == CONTENTTYPE_MOVIE)
+                genre->moviesCount++;
+            else
+                genre->seriesCount++;
+        }
+        if (title == CONTENTTYPE_MOVIE)
+            year->moviesCount++;
+        else
+            year->seriesCount++;
+        TRecord record = rawRecord(content);
+        offerBest(media, year, &record, content->primaryTitle);
+        return 1;
+    }
+
+    /// Se añade la película/serie en sus generos correspondientes.
+    for ( size_t i=0; i < content->genresCount; i++)
+        if (addToGenre(media, year, genreIds[i], names[i], id, title) == MEM_ERROR)
+            return MEM_ERROR;
+
+    /// Se actualiza la cantidad de películas/series añadidas. A pesar de que la misma película/serie se añadio a varios
+    /// generos (si es que tiene mas de uno), se contabilizara una sola vez. Ademas, se actualiza la mejor serie/pelicula
+    /// con su cantidad de votos.
+    if (offerTop(media, title == CONTENTTYPE_MOVIE ? &year->topMovies : &year->topSeries, id) == MEM_ERROR ||
+        sketchContent(media, title == CONTENTTYPE_MOVIE ? &year->moviesSketch : &year->seriesSketch, id) == MEM_ERROR)
+        return MEM_ERROR;
+    if ( title == CONTENTTYPE_MOVIE){
+        (year->moviesCount)++;
+        if ( content->numVotes > year->bestMovieRating){
+            year->bestMovieRating = content->numVotes;
+            year->bestMovie = id;
+        }
+    }
+    else {
+        (year->seriesCount++);
+        if (content->numVotes > year->bestSeriesRating){
+            year->bestSeriesRating= content->numVotes;
+            year->bestSeries = id;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que añade una fila al TAD (ver addRawContent()).
+ */
+static int insertContent( mediaADT media , const TRawContent * content ){
+    const unsigned short year = content->startYear;
+    const contentType title = content->type;
+    /// Se valida si el año pasado como parametro es válido dentro del mediaADT
+    if ( isYearValid(media, year) == INVALIDYEAR_ERROR){
+        return INVALIDYEAR_ERROR;
+    }
+
+    /// Se valida si el contenido a añadir es una pelicula o serie
+    if ( title != CONTENTTYPE_MOVIE && title != CONTENTTYPE_SERIES){
+        return CONTENTTYPE_ERROR;
+    }
+    CHECK_MEM(reserveYear(media, year));
+    int index= POS(year, media->baseYear);
+
+    /// Cada genero se resuelve a su identificador una unica vez mediante el diccionario, y luego se accede
+    /// directamente a la tabla del año.
+    TSlice names[MAX_GENRES];
+    TGenreId genreIds[MAX_GENRES];
+    if (internRowGenres(media, content, names, genreIds, NULL) == MEM_ERROR)
+        return MEM_ERROR;
+
+    /// La pelicula/serie se copia una unica vez en el almacen central (salvo en modo MEDIA_AGGREGATE). Los generos y
+    /// el año solo guardan su indice.
+    TContentId id = media->contentsCount;
+    if (media->mode == MEDIA_FULL && storeContent(media, content, genreIds) == MEM_ERROR)
+        return MEM_ERROR;
+    if (reserveRanges(media) == MEM_ERROR || placeContent(media, media->years[index], content, names, genreIds, id) == MEM_ERROR)
+        return MEM_ERROR;
+    for ( size_t i=0; i < content->genresCount; i++)
+        if (countRange(media, index, genreIds[i], title, 1) == MEM_ERROR)
+            return MEM_ERROR;
+    return countRange(media, index, NO_GENRE, title, 1);
+}
+
+int addRawContent( mediaADT media , const TRawContent * content ){
+#ifndef MEDIA_NO_STATS
+    /// Leer el reloj cuesta lo mismo que parte de una insercion, por lo que se mide una de cada STATS_SAMPLE filas.
+    if (media->statsTick++ % STATS_SAMPLE == 0){
+        unsigned long long start = statsNow();
+        int out = insertContent(media, content);
+        media->stats.insertNs += (statsNow() - start) * STATS_SAMPLE;
+        return countRow(media, out, &media->stats.rowsAdded);
+    }
+#endif
+    return countRow(media, insertContent(media, content), &media->stats.rowsAdded);
+}
+
+/**
+ * @brief Funcion auxiliar de addContentBatch() que registra en los arboles de cantidades por año lo añadido a un año
+ * por las filas de un grupo, con un unico cambio por genero y tipo. Las cantidades acumuladas vuelven a cero.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param index Posicion del año en el vector de años.
+ * @param deltas Cantidades añadidas: dos por genero (peliculas y series) y las dos ultimas para el total del año.
+ * @param touched Generos con cantidades añadidas.
+ * @param touchedCount Cantidad de generos de "touched".
+ * @return 1 si se registraron correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int countGroup(mediaADT media, const size_t index, size_t * deltas, const TGenreId * touched,
+                      const size_t touchedCount){
+    const size_t yearDeltas = 2 * media->dict.count;
+    int out = 1;
+    for (size_t i = 0; i < touchedCount; i++)
+        for (int type = 0; type < 2; type++){
+            size_t * delta = &deltas[2 * touched[i] + type];
+            if (*delta > 0 && countRange(media, index, touched[i], CONTENTTYPE_MOVIE + type, *delta) == MEM_ERROR)
+                out = MEM_ERROR;
+            *delta = 0;
+        }
+    for (int type = 0; type < 2; type++){
+        if (deltas[yearDeltas + type] > 0 &&
+            countRange(media, index, NO_GENRE, CONTENTTYPE_MOVIE + type, deltas[yearDeltas + type]) == MEM_ERROR)
+            out = MEM_ERROR;
+        deltas[yearDeltas + type] = 0;
+    }
+    return out;
+}
+
+int addContentBatch(mediaADT media, const TRawContent * rows, const size_t n, int * status){
+    unsigned long long start = statsNow();
+    size_t genresTotal = 0;
+    for (size_t i = 0; i < n; i++)
+        genresTotal += rows[i].genresCount;
+    TBatchRow * batch = malloc(sizeof(TBatchRow) * (n + 1));
+    TSlice * names = malloc(sizeof(TSlice) * (genresTotal + 1));
+    TGenreId * genreIds = malloc(sizeof(TGenreId) * (genresTotal + 1));
+    TBatchGenres cache = { NULL, 0, 0 };
+    int out = batch == NULL || names == NULL || genreIds == NULL ? MEM_ERROR : 1;
+
+    /// Primera pasada, en el orden de entrada: se validan las filas y se resuelven sus generos (cada forma de
+    /// escribir un genero se busca en el diccionario una unica vez por lote).
+    size_t valid = 0;
+    unsigned short minYear = 0, maxYear = 0;
+    for (size_t i = 0, genres = 0; i < n; genres += rows[i++].genresCount){
+        const TRawContent * row = &rows[i];
+        if (out == MEM_ERROR)
+            status[i] = MEM_ERROR;
+        else if (isYearValid(media, row->startYear) == INVALIDYEAR_ERROR)
+            status[i] = INVALIDYEAR_ERROR;
+        else if (row->type != CONTENTTYPE_MOVIE && row->type != CONTENTTYPE_SERIES)
+            status[i] = CONTENTTYPE_ERROR;
+        else {
+            batch[i].genres = genres;
+            if (internRowGenres(media, row, names + genres, genreIds + genres, &cache) == MEM_ERROR)
+                out = MEM_ERROR;
+            if (valid++ == 0 || row->startYear < minYear)
+                minYear = row->startYear;
+            if (row->startYear > maxYear)
+                maxYear = row->startYear;
+            status[i] = out;
+        }
+    }
+    free(cache.table);
+
+    /// Las filas validas se agrupan por año (cada grupo en el orden de entrada) antes de reservar nada.
+    size_t span = valid == 0 ? 0 : (size_t)(maxYear - minYear) + 1;
+    size_t * heads = NULL, * tails = NULL;
+    if (out != MEM_ERROR && span > 0){
+        heads = malloc(sizeof(size_t) * span);
+        tails = malloc(sizeof(size_t) * span);
+        if (heads == NULL || tails == NULL)
+            out = MEM_ERROR;
     }
-    for (size_t i=0; i < media->size; i++){
-        if (media->years[i] != NULL){
-            freeYear(media->years[i]);
+    for (size_t y = 0; out != MEM_ERROR && y < span; y++)
+        heads[y] = n;
+    for (size_t i = 0; out != MEM_ERROR && i < n; i++){
+        if (status[i] != 1)
+            continue;
+        size_t group = rows[i].startYear - minYear;
+        batch[i].next = n;
+        if (heads[group] == n)
+            heads[group] = i;
+        else
+            batch[tails[group]].next = i;
+        tails[group] = i;
+    }
+
+    /// Cada año distinto se reserva una unica vez y el almacen central se agranda una unica vez para todo el lote.
+    /// Las filas se copian al almacen en el orden de entrada, por lo que los indices quedan contiguos y en el mismo
+    /// orden que con addRawContent().
+    for (size_t y = 0; out != MEM_ERROR && y < span; y++)
+        if (heads[y] != n && reserveYear(media, minYear + y) == NULL)
+            out = MEM_ERROR;
+    if (out != MEM_ERROR && media->mode == MEDIA_FULL && reserveStore(media, valid) == MEM_ERROR)
+        out = MEM_ERROR;
+    for (size_t i = 0; out != MEM_ERROR && i < n; i++){
+        if (status[i] != 1)
+            continue;
+        batch[i].id = media->contentsCount;
+        if (media->mode == MEDIA_FULL && storeContent(media, &rows[i], genreIds + batch[i].genres) == MEM_ERROR)
+            out = MEM_ERROR;
+    }
+
+    /// Los arboles de cantidades se agrandan antes de actualizar las cantidades, una vez que el vector de años ya no
+    /// se desplaza.
+    size_t * deltas = NULL;
+    TGenreId * touched = NULL;
+    if (out != MEM_ERROR && span > 0){
+        deltas = calloc(2 * (media->dict.count + 1), sizeof(size_t));
+        touched = malloc(sizeof(TGenreId) * (media->dict.count + 1));
+        if (deltas == NULL || touched == NULL || reserveRanges(media) == MEM_ERROR)
+            out = MEM_ERROR;
+    }
+
+    /// Segunda pasada, de a un año por vez: primero se cuenta lo que el grupo añade a cada genero, para reservar de
+    /// una vez el lugar de sus indices, y luego se ubican sus filas. Las cantidades se registran en los arboles con un
+    /// unico cambio por genero y tipo.
+    for (size_t y = 0; out != MEM_ERROR && y < span; y++){
+        if (heads[y] == n)
+            continue;
+        const size_t index = POS(minYear + y, media->baseYear);
+        TYear year = media->years[index];
+        size_t touchedCount = 0;
+        for (size_t i = heads[y]; i != n; i = batch[i].next){
+            const TRawContent * row = &rows[i];
+            const TGenreId * ids = genreIds + batch[i].genres;
+            for (size_t j = 0; j < row->genresCount; j++){
+                if (deltas[2 * ids[j]] == 0 && deltas[2 * ids[j] + 1] == 0)
+                    touched[touchedCount++] = ids[j];
+                deltas[2 * ids[j] + (row->type - CONTENTTYPE_MOVIE)]++;
+            }
+            deltas[2 * media->dict.count + (row->type - CONTENTTYPE_MOVIE)]++;
         }
+        for (size_t j = 0; media->mode == MEDIA_FULL && j < touchedCount && out != MEM_ERROR; j++){
+            TGenre * genre = yearGenre(media, year, touched[j]);
+            if (genre == NULL || reserveIds(media->arena, &genre->movies, deltas[2 * touched[j]]) == MEM_ERROR ||
+                reserveIds(media->arena, &genre->series, deltas[2 * touched[j] + 1]) == MEM_ERROR)
+                out = MEM_ERROR;
+        }
+        for (size_t i = heads[y]; i != n && out != MEM_ERROR; i = batch[i].next)
+            if (placeContent(media, year, &rows[i], names + batch[i].genres, genreIds + batch[i].genres,
+                             batch[i].id) == MEM_ERROR)
+                out = MEM_ERROR;
+        if (out == MEM_ERROR || countGroup(media, index, deltas, touched, touchedCount) == MEM_ERROR)
+            out = MEM_ERROR;
+    }
+    free(batch);
+    free(names);
+    free(genreIds);
+    free(heads);
+    free(tails);
+    free(deltas);
+    free(touched);
+
+    /// Ante un error de memoria no se puede saber que filas quedaron completas, por lo que se informa en todas.
+    for (size_t i = 0; i < n; i++){
+        if (out == MEM_ERROR && status[i] == 1)
+            status[i] = MEM_ERROR;
+        countRow(media, status[i], &media->stats.rowsAdded);
+    }
+    STATS_ADD(media, insertNs, statsNow() - start);
+    return out;
+}
+
+/**
+ * @brief Funcion auxiliar que agrega a un genero todos los indices de una lista de bloques, desplazados en "offset".
+ *
+ * @param arena Arena del cual se toma la memoria.
+ * @param first Puntero al primer bloque de la lista destino, que se actualiza al agregar bloques.
+ * @param from Primer bloque de la lista a agregar.
+ * @param offset Desplazamiento a sumar a cada indice.
+ * @return 1 si se agregaron correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int appendIds(arenaADT arena, TIdBlock ** first, const TIdBlock * from, const TContentId offset){
+    /// Los bloques guardan primero al mas reciente, por lo que se agregan desde el ultimo para conservar el orden.
+    if (from == NULL)
+        return 1;
+    if (appendIds(arena, first, from->next, offset) == MEM_ERROR)
+        return MEM_ERROR;
+    for (size_t i = 0; i < from->count; i++)
+        CHECK_MEM(*first = appendId(arena, *first, from->ids[i] + offset));
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que ofrece a un heap los indices de un heap de otro TAD, desplazados en "offset". Los mas
+ * votados de la union estan entre los mas votados de cada parte.
+ */
+static int offerHeap(mediaADT media, TTopHeap ** heap, const TTopHeap * from, const TContentId offset){
+    for (size_t i = 0; from != NULL && i < from->count; i++)
+        if (offerTop(media, heap, from->ids[i] + offset) == MEM_ERROR)
+            return MEM_ERROR;
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que suma las estadisticas de otro TAD a las del TAD destino. Si los TAD no comparten el
+ * arena, tambien se suman las reservas del arena de "other", que suele liberarse luego de combinarlo.
+ */
+static void mergeStats(mediaADT media, const mediaADT other){
+#ifndef MEDIA_NO_STATS
+    TMediaStats * to = &media->stats;
+    const TMediaStats * from = &other->stats;
+    to->rowsAdded += from->rowsAdded;
+    to->rowsCorrected += from->rowsCorrected;
+    to->rowsRejected += from->rowsRejected;
+    to->rowsInvalidYear += from->rowsInvalidYear;
+    to->contentsMerged += from->contentsMerged + other->contentsCount;
+    to->arenaAllocs += from->arenaAllocs;
+    to->arenaBytes += from->arenaBytes;
+    if (other->arena != NULL && other->arena != media->arena){
+        to->arenaAllocs += arenaAllocations(other->arena);
+        to->arenaBytes += arenaUsed(other->arena);
+    }
+    to->tableGrowths += from->tableGrowths;
+    to->tableGrowthBytes += from->tableGrowthBytes;
+    to->genreLookups += from->genreLookups;
+    to->genreProbes += from->genreProbes;
+    to->insertNs += from->insertNs;
+    to->correctNs += from->correctNs;
+    to->mergeNs += from->mergeNs;
+    to->saveNs += from->saveNs;
+    to->loadNs += from->loadNs;
+#else
+    (void)media;
+    (void)other;
+#endif
+}
+
+/**
+ * @brief Funcion auxiliar que suma la matriz de pares de generos de un año de otro TAD a la del mismo año del TAD
+ * destino, traduciendo los identificadores de genero.
+ *
+ * @param media ADT destino.
+ * @param to Año del TAD destino.
+ * @param from Año del TAD de origen.
+ * @param genreMap Identificador en "media" de cada genero del TAD de origen.
+ * @return 1 si se sumo correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int mergePairs(mediaADT media, TYear to, const TYear from, const TGenreId * genreMap){
+    for (TGenreId a = 1; a < from->pairsGenres; a++)
+        for (TGenreId b = 0; b < a; b++){
+            const size_t * counts = from->pairs + 2 * PAIR_POS(a, b);
+            if (counts[0] == 0 && counts[1] == 0)
+                continue;
+            /// Al traducirse, el orden entre ambos identificadores puede invertirse.
+            TGenreId high = genreMap[a] > genreMap[b] ? genreMap[a] : genreMap[b];
+            TGenreId low = genreMap[a] > genreMap[b] ? genreMap[b] : genreMap[a];
+            if (yearPairs(media, to, high) == MEM_ERROR)
+                return MEM_ERROR;
+            to->pairs[2 * PAIR_POS(high, low)] += counts[0];
+            to->pairs[2 * PAIR_POS(high, low) + 1] += counts[1];
+        }
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que combina un año de otro TAD con el mismo año del TAD destino.
+ *
+ * @param media ADT destino.
+ * @param from Año del TAD de origen.
+ * @param year Año a combinar.
+ * @param offset Indice en "media" del primer contenido copiado desde "other".
+ * @param other TAD de origen, del cual se leen las mas votadas en modo MEDIA_AGGREGATE.
+ * @param genreMap Identificador en "media" de cada genero de "other".
+ * @return 1 si se combino correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int mergeYear(mediaADT media, const TYear from, const unsigned short year, const TContentId offset,
+                     const mediaADT other, const TGenreId * genreMap){
+    TYear to = reserveYear(media, year);
+    CHECK_MEM(to);
+    if (mergePairs(media, to, from, genreMap) == MEM_ERROR)
+        return MEM_ERROR;
+    for (TGenreId i = 0; i < from->genresSize; i++){
+        const TGenre * fromGenre = &from->genres[i];
+        if (fromGenre->name == NULL)
+            continue;
+        TSlice name = { fromGenre->name, strlen(fromGenre->name) };
+        TGenreId genreId = internGenre(media, name);
+        if (genreId == NO_GENRE)
+            return MEM_ERROR;
+        TGenre * toGenre = yearGenre(media, to, genreId);
+        CHECK_MEM(toGenre);
+        /// Si el genero no existia en el año destino, se conserva el nombre tal como aparecio en "other".
+        if (toGenre->name == NULL)
+            CHECK_MEM(toGenre->name = genreSpelling(media->arena, &media->dict, genreId, name));
+        if (appendIds(media->arena, &toGenre->movies, fromGenre->movies, offset) == MEM_ERROR ||
+            appendIds(media->arena, &toGenre->series, fromGenre->series, offset) == MEM_ERROR)
+            return MEM_ERROR;
+        toGenre->moviesCount += fromGenre->moviesCount;
+        if (countRange(media, POS(year, media->baseYear), genreId, CONTENTTYPE_MOVIE, fromGenre->moviesCount) == MEM_ERROR)
+            return MEM_ERROR;
+        toGenre->seriesCount += fromGenre->seriesCount;
+        if (countRange(media, POS(year, media->baseYear), genreId, CONTENTTYPE_SERIES, fromGenre->seriesCount) == MEM_ERROR)
+            return MEM_ERROR;
+        if (offerHeap(media, &toGenre->topMovies, fromGenre->topMovies, offset) == MEM_ERROR ||
+            offerHeap(media, &toGenre->topSeries, fromGenre->topSeries, offset) == MEM_ERROR ||
+            mergeSketch(media, &toGenre->moviesSketch, fromGenre->moviesSketch) == MEM_ERROR ||
+            mergeSketch(media, &toGenre->seriesSketch, fromGenre->seriesSketch) == MEM_ERROR)
+            return MEM_ERROR;
+    }
+    if (offerHeap(media, &to->topMovies, from->topMovies, offset) == MEM_ERROR ||
+        offerHeap(media, &to->topSeries, from->topSeries, offset) == MEM_ERROR ||
+        mergeSketch(media, &to->moviesSketch, from->moviesSketch) == MEM_ERROR ||
+        mergeSketch(media, &to->seriesSketch, from->seriesSketch) == MEM_ERROR)
+        return MEM_ERROR;
+
+    /// Ante igual cantidad de votos se conserva el contenido de "media", que aparecio antes en la entrada.
+    if (media->mode == MEDIA_AGGREGATE){
+        TContentId best[] = { from->bestMovie, from->bestSeries };
+        for (int i = 0; i < 2; i++){
+            TRecord record = loadRecord(other, best[i]);
+            TSlice title = { REL_GET(COLUMN(other, best[i], title)), strlen(REL_GET(COLUMN(other, best[i], title))) };
+            offerBest(media, to, &record, title);
+        }
+    }
+    else if (from->bestMovieRating > to->bestMovieRating){
+        to->bestMovieRating = from->bestMovieRating;
+        to->bestMovie = from->bestMovie + offset;
+    }
+    if (media->mode == MEDIA_FULL && from->bestSeriesRating > to->bestSeriesRating){
+        to->bestSeriesRating = from->bestSeriesRating;
+        to->bestSeries = from->bestSeries + offset;
+    }
+    to->moviesCount += from->moviesCount;
+    if (countRange(media, POS(year, media->baseYear), NO_GENRE, CONTENTTYPE_MOVIE, from->moviesCount) == MEM_ERROR)
+        return MEM_ERROR;
+    to->seriesCount += from->seriesCount;
+    return countRange(media, POS(year, media->baseYear), NO_GENRE, CONTENTTYPE_SERIES, from->seriesCount);
+}
+
+int mergeMediaADT(mediaADT media, const mediaADT other){
+    if (media->minYear != other->minYear)
+        return INVALIDYEAR_ERROR;
+    if (media->mode != other->mode)
+        return RANGE_ERROR;
+    unsigned long long start = statsNow();
+
+    /// Los identificadores de genero de "other" se traducen a los del diccionario de "media".
+    TGenreId * genreMap = malloc(sizeof(TGenreId) * (other->dict.count + 1));
+    CHECK_MEM(genreMap);
+    for (size_t i = 0; i < other->dict.count; i++){
+        TSlice name = { other->dict.names[i]->name, strlen(other->dict.names[i]->name) };
+        if ((genreMap[i] = internGenre(media, name)) == NO_GENRE){
+            free(genreMap);
+            return MEM_ERROR;
+        }
+    }
+
+    /// Se copian al final del almacen central todos los contenidos de "other", en el mismo orden. Asi, el indice de
+    /// cada contenido en "media" es su indice en "other" mas "offset".
+    /// En modo MEDIA_AGGREGATE el almacen solo tiene las mas votadas de cada año, que se combinan con mergeYear.
+    TContentId offset = media->contentsCount;
+    for (TContentId id = 0; media->mode == MEDIA_FULL && id < other->contentsCount; id++){
+        TRecord record = loadRecord(other, id);
+        const char * title = REL_GET(COLUMN(other, id, title));
+        TGenreId genres[MAX_GENRES];
+        for (size_t i = 0; i < record.genresCount; i++)
+            genres[i] = genreMap[GENRES_OF(other, id)[i]];
+        if (storeRecord(media, &record, title, strlen(title), genres) == MEM_ERROR){
+            free(genreMap);
+            return MEM_ERROR;
+        }
+    }
+
+    for (size_t i = 0; i < other->size; i++)
+        if (other->years[i] != NULL &&
+            mergeYear(media, other->years[i], YEAR(i, other->baseYear), offset, other, genreMap) == MEM_ERROR){
+            free(genreMap);
+            return MEM_ERROR;
+        }
+    free(genreMap);
+    STATS_ADD(media, mergeNs, statsNow() - start);
+    mergeStats(media, other);
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar de hash (FNV-1a) sobre el titulo de un contenido.
+ */
+static size_t hashTitle(const TSlice title){
+    size_t h = 2166136261u;
+    for (size_t i = 0; i < title.len; i++)
+        h = (h ^ (unsigned char)title.str[i]) * 16777619u;
+    return h;
+}
+
+/**
+ * @brief Funcion auxiliar de hash sobre la clave de un contenido: continua el hash del titulo con el año de comienzo
+ * y el tipo.
+ */
+static size_t hashKey(const TSlice title, const unsigned short year, const unsigned char type){
+    size_t h = (hashTitle(title) ^ year) * 16777619u;
+    return (h ^ type) * 16777619u;
+}
+
+/**
+ * @brief Funcion auxiliar que busca la posicion de una clave en la tabla de claves de contenidos.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param table Tabla de claves en la que se busca (la del TAD o la que se escribe en un snapshot).
+ * @param tableSize Cantidad de posiciones de la tabla (potencia de 2, mayor a 0).
+ * @param title Titulo del contenido.
+ * @param year Año de comienzo del contenido.
+ * @param type Tipo del contenido.
+ * @return Posicion de la tabla que contiene a la clave, o la posicion libre donde deberia insertarse.
+ */
+static size_t probeKey(const mediaADT media, const TContentId * table, const size_t tableSize, const TSlice title,
+                       const unsigned short year, const unsigned char type){
+    size_t mask = tableSize - 1;
+    size_t i = hashKey(title, year, type) & mask;
+    while (table[i] != 0){
+        TContentId id = table[i] - 1;
+        const char * name = REL_GET(COLUMN(media, id, title));
+        if (COLUMN(media, id, startYear) == year && COLUMN(media, id, type) == type &&
+            strncmp(name, title.str, title.len) == 0 &&
+            name[title.len] == '\0')
+            return i;
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve la cantidad de posiciones de la tabla de claves para "count" contenidos, de
+ * modo que su factor de carga quede por debajo del 50%.
+ */
+static size_t keyTableSizeFor(const size_t count){
+    size_t size = KEY_BLOCK;
+    while (count * 2 >= size)
+        size *= 2;
+    return size;
+}
+
+/**
+ * @brief Funcion auxiliar que indica si un puntero apunta dentro del snapshot mapeado del TAD (y por lo tanto no
+ * debe liberarse).
+ */
+static int isMapped(const mediaADT media, const void * ptr){
+    return media->mapping != NULL && (const char *)ptr >= (const char *)media->mapping &&
+           (const char *)ptr < (const char *)media->mapping + media->mappingSize;
+}
+
+/**
+ * @brief Funcion auxiliar que registra en la tabla de claves los contenidos añadidos desde el ultimo registro.
+ *
+ * @details La tabla se arma recien cuando se corrige contenido por primera vez, por lo que la carga inicial no paga
+ * su costo; luego solo se registran los contenidos nuevos. Ante claves repetidas prevalece el contenido posterior.
+ * El snapshot guarda la tabla completa, por lo que luego de cargarlo una correccion solo registra lo añadido desde
+ * entonces y cuesta lo mismo que las novedades, no que todo el TAD.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @return 1 si la tabla quedo actualizada o MEM_ERROR si se produjo un error de memoria.
+ */
+static int indexContents(mediaADT media){
+    /// Se mantiene el factor de carga de la tabla por debajo del 50%
+    if (media->contentsCount * 2 >= media->keyTableSize){
+        size_t size = keyTableSizeFor(media->contentsCount);
+        TContentId * old = media->keyTable;
+        size_t oldSize = media->keyTableSize;
+        CHECK_MEM(media->keyTable = calloc(size, sizeof(TContentId)));
+        media->keyTableSize = size;
+        STATS_ADD(media, tableGrowths, 1);
+        STATS_ADD(media, tableGrowthBytes, size * sizeof(TContentId));
+        for (size_t i = 0; i < oldSize; i++)
+            if (old[i] != 0){
+                TContentId id = old[i] - 1;
+                TSlice title = { REL_GET(COLUMN(media, id, title)), strlen(REL_GET(COLUMN(media, id, title))) };
+                media->keyTable[probeKey(media, media->keyTable, size, title, COLUMN(media, id, startYear),
+                                         COLUMN(media, id, type))] = old[i];
+            }
+        /// La tabla cargada desde un snapshot queda dentro del mapeo, que se libera junto con el mismo.
+        if (!isMapped(media, old))
+            free(old);
+    }
+    for (; media->keyedCount < media->contentsCount; media->keyedCount++){
+        TContentId id = media->keyedCount;
+        TSlice title = { REL_GET(COLUMN(media, id, title)), strlen(REL_GET(COLUMN(media, id, title))) };
+        media->keyTable[probeKey(media, media->keyTable, media->keyTableSize, title, COLUMN(media, id, startYear),
+                                 COLUMN(media, id, type))] = id + 1;
+    }
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve el titulo de un contenido del almacen central.
+ */
+static const char * titleOf(const mediaADT media, const TContentId id){
+    return REL_GET(COLUMN(media, id, title));
+}
+
+/**
+ * @brief Funcion auxiliar que indica si el contenido "a" va antes que "b" en el indice ordenado de titulos: por
+ * titulo y, con el mismo titulo, por orden de carga.
+ */
+static int titleBefore(const mediaADT media, const TContentId a, const TContentId b){
+    int cmp = strcmp(titleOf(media, a), titleOf(media, b));
+    return cmp < 0 || (cmp == 0 && a < b);
+}
+
+/**
+ * @brief Funcion auxiliar que intercala dos vectores de indices ordenados por titulo.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param a Primer vector ordenado.
+ * @param na Cantidad de indices de "a".
+ * @param b Segundo vector ordenado.
+ * @param nb Cantidad de indices de "b".
+ * @param out Vector destino de na + nb posiciones.
+ */
+static void mergeTitles(const mediaADT media, const TContentId * a, const size_t na, const TContentId * b,
+                        const size_t nb, TContentId * out){
+    size_t i = 0, j = 0;
+    while (i < na && j < nb)
+        *out++ = titleBefore(media, b[j], a[i]) ? b[j++] : a[i++];
+    while (i < na)
+        *out++ = a[i++];
+    while (j < nb)
+        *out++ = b[j++];
+}
+
+/**
+ * @brief Funcion auxiliar que ordena por titulo un vector de indices (merge sort iterativo).
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param ids Vector a ordenar.
+ * @param aux Vector auxiliar de la misma cantidad de posiciones.
+ * @param n Cantidad de indices.
+ * @return Vector ordenado: "ids" o "aux", segun la cantidad de pasadas.
+ */
+static TContentId * sortTitles(const mediaADT media, TContentId * ids, TContentId * aux, const size_t n){
+    for (size_t width = 1; width < n; width *= 2){
+        for (size_t low = 0; low < n; low += 2 * width){
+            size_t mid = low + width < n ? low + width : n;
+            size_t high = low + 2 * width < n ? low + 2 * width : n;
+            mergeTitles(media, ids + low, mid - low, ids + mid, high - mid, aux + low);
+        }
+        TContentId * swap = ids;
+        ids = aux;
+        aux = swap;
+    }
+    return ids;
+}
+
+/**
+ * @brief Funcion auxiliar que registra un contenido en la tabla de hash de titulos. Los titulos repetidos ocupan
+ * posiciones distintas de la misma secuencia de sondeo.
+ */
+static void hashTitleId(mediaADT media, const TContentId id){
+    const char * title = titleOf(media, id);
+    size_t mask = media->titleTableSize - 1;
+    size_t i = hashTitle((TSlice){ title, strlen(title) }) & mask;
+    while (media->titleTable[i] != 0)
+        i = (i + 1) & mask;
+    media->titleTable[i] = id + 1;
+}
+
+int indexTitles(mediaADT media){
+    if (media->mode == MEDIA_AGGREGATE)
+        return RANGE_ERROR;
+    size_t added = media->contentsCount - media->titledCount;
+    if (added == 0)
+        return 1;
+
+    /// Se reservan primero todos los vectores, para que ante un error de memoria el indice quede como estaba.
+    TContentId * table = NULL;
+    size_t tableSize = media->titleTableSize;
+    if (media->contentsCount * 2 >= tableSize){
+        tableSize = tableSize == 0 ? KEY_BLOCK : tableSize;
+        while (media->contentsCount * 2 >= tableSize)
+            tableSize *= 2;
+        CHECK_MEM(table = calloc(tableSize, sizeof(TContentId)));
+    }
+    TContentId * order = malloc(sizeof(TContentId) * media->contentsCount);
+    TContentId * work = malloc(sizeof(TContentId) * added * 2);
+    if (order == NULL || work == NULL){
+        free(table);
+        free(order);
+        free(work);
+        return MEM_ERROR;
+    }
+
+    /// Tabla de hash: si crece, se vuelven a registrar los contenidos anteriores.
+    if (table != NULL){
+        free(media->titleTable);
+        media->titleTable = table;
+        media->titleTableSize = tableSize;
+        for (TContentId id = 0; id < media->titledCount; id++)
+            hashTitleId(media, id);
+    }
+    for (TContentId id = media->titledCount; id < media->contentsCount; id++)
+        hashTitleId(media, id);
+
+    /// Vector ordenado: solo se ordenan los contenidos nuevos y luego se intercalan con los anteriores.
+    for (size_t i = 0; i < added; i++)
+        work[i] = media->titledCount + i;
+    TContentId * sorted = sortTitles(media, work, work + added, added);
+    mergeTitles(media, media->titleOrder, media->titledCount, sorted, added, order);
+    free(work);
+    free(media->titleOrder);
+    media->titleOrder = order;
+    media->titledCount = media->contentsCount;
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que arma el resultado de una busqueda por titulo a partir de un indice del almacen central.
+ */
+static TTitleMatch titleMatch(const mediaADT media, const TContentId id){
+    TTitleMatch match;
+    match.handle = id;
+    match.primaryTitle = titleOf(media, id);
+    match.startYear = COLUMN(media, id, startYear);
+    match.type = COLUMN(media, id, type);
+    match.numVotes = COLUMN(media, id, numVotes);
+    match.averageRating = COLUMN(media, id, averageRating);
+    return match;
+}
+
+size_t findTitle(const mediaADT media, const char * title, TTitleMatch * matches, const size_t max){
+    if (media->titleTableSize == 0)
+        return 0;
+    size_t count = 0;
+    size_t mask = media->titleTableSize - 1;
+    for (size_t i = hashTitle((TSlice){ title, strlen(title) }) & mask; media->titleTable[i] != 0; i = (i + 1) & mask){
+        TContentId id = media->titleTable[i] - 1;
+        if (strcmp(titleOf(media, id), title) == 0 && count++ < max)
+            matches[count - 1] = titleMatch(media, id);
+    }
+    return count;
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve la primera posicion del indice ordenado cuyo titulo no va antes que "prefix"
+ * (con "upper" en 0) o cuyo titulo va despues de todos los que comienzan con "prefix" (con "upper" en 1).
+ */
+static size_t titleBound(const mediaADT media, const char * prefix, const size_t len, const int upper){
+    size_t low = 0, high = media->titledCount;
+    while (low < high){
+        size_t mid = low + (high - low) / 2;
+        int cmp = strncmp(titleOf(media, media->titleOrder[mid]), prefix, len);
+        if (cmp < 0 || (upper && cmp == 0))
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+size_t findTitlePrefix(const mediaADT media, const char * prefix, TTitleMatch * matches, const size_t max){
+    size_t len = strlen(prefix);
+    size_t first = titleBound(media, prefix, len, 0);
+    size_t last = titleBound(media, prefix, len, 1);
+    for (size_t i = first; i < last && i - first < max; i++)
+        matches[i - first] = titleMatch(media, media->titleOrder[i]);
+    return last - first;
+}
+
+/**
+ * @brief Funcion auxiliar que copia en el arena los bloques de una lista desde "*link" hasta "last" inclusive y los
+ * enlaza en su lugar. Los bloques originales siguen perteneciendo a las versiones publicadas que los comparten.
+ *
+ * @return Copia de "last" o NULL si se produjo un error de memoria.
+ */
+static TIdBlock * copyIds(arenaADT arena, TIdBlock ** link, const TIdBlock * last){
+    while (1){
+        const TIdBlock * block = *link;
+        size_t size = sizeof(TIdBlock) + block->capacity * sizeof(TContentId);
+        TIdBlock * copy = arenaAlloc(arena, size);
+        if (copy == NULL)
+            return NULL;
+        memcpy(copy, block, size);
+        copy->shared = 0;
+        *link = copy;
+        if (block == last)
+            return copy;
+        link = &copy->next;
+    }
+}
+
+/**
+ * @brief Funcion auxiliar que quita un indice de una lista de bloques, reemplazandolo por el ultimo indice añadido.
+ * Los bloques compartidos con versiones publicadas que deben modificarse se copian antes (@see freezeIds).
+ *
+ * @param arena Arena del cual se toma la memoria de las copias.
+ * @param first Puntero al primer bloque de la lista, que se actualiza si el mismo queda vacio o se copia.
+ * @param id Indice a quitar.
+ * @return 1 si se encontro el indice, 0 si no estaba en la lista o MEM_ERROR si se produjo un error de memoria.
+ */
+static int removeId(arenaADT arena, TIdBlock ** first, const TContentId id){
+    TIdBlock ** shared = NULL;
+    for (TIdBlock ** link = first; *link != NULL; link = &(*link)->next){
+        TIdBlock * block = *link;
+        if (shared == NULL && block->shared)
+            shared = link;
+        for (size_t i = 0; i < block->count; i++)
+            if (block->ids[i] == id){
+                /// Se modifican el bloque del indice y el primero, por lo que se copian los compartidos hasta el.
+                if (shared != NULL && (block = copyIds(arena, shared, block)) == NULL)
+                    return MEM_ERROR;
+                block->ids[i] = (*first)->ids[--(*first)->count];
+                if ((*first)->count == 0)
+                    *first = (*first)->next;
+                return 1;
+            }
+    }
+    return 0;
+}
+
+/**
+ * @brief Funcion auxiliar que indica si un contenido supera al mas votado de su año. Ante igual cantidad de votos
+ * prevalece el de menor indice, es decir, el que se añadio primero.
+ */
+static int beats(const unsigned long votes, const TContentId id, const size_t bestVotes, const TContentId best){
+    return votes > bestVotes || (votes > 0 && votes == bestVotes && id < best);
+}
+
+/**
+ * @brief Funcion auxiliar que actualiza la pelicula/serie mas votada de un año luego de corregir uno de sus contenidos.
+ *
+ * @details Solo si el contenido corregido era el mas votado y perdio votos se recorren los contenidos del año.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año del contenido corregido.
+ * @param id Indice del contenido corregido.
+ */
+static void updateBest(const mediaADT media, TYear year, const TContentId id){
+    unsigned long numVotes = COLUMN(media, id, numVotes);
+    int isMovie = COLUMN(media, id, type) == CONTENTTYPE_MOVIE;
+    TContentId * best = isMovie ? &year->bestMovie : &year->bestSeries;
+    size_t * bestVotes = isMovie ? &year->bestMovieRating : &year->bestSeriesRating;
+
+    if (*bestVotes == 0 || *best != id || numVotes >= *bestVotes){
+        if (*best == id || beats(numVotes, id, *bestVotes, *best)){
+            *best = id;
+            *bestVotes = numVotes;
+        }
+        return;
+    }
+
+    *bestVotes = numVotes;
+    for (size_t i = 0; i < year->genresSize; i++)
+        for (const TIdBlock * block = isMovie ? year->genres[i].movies : year->genres[i].series; block != NULL;
+             block = block->next)
+            for (size_t j = 0; j < block->count; j++){
+                unsigned long votes = COLUMN(media, block->ids[j], numVotes);
+                if (beats(votes, block->ids[j], *bestVotes, *best)){
+                    *best = block->ids[j];
+                    *bestVotes = votes;
+                }
+            }
+}
+
+/**
+ * @brief Funcion auxiliar que actualiza un heap de mas votadas luego de que cambiaran los votos de un contenido.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param heap Puntero al heap.
+ * @param id Indice del contenido corregido (ya con sus votos nuevos).
+ * @param oldVotes Votos que tenia el contenido antes de corregirlo.
+ * @return 1 si el heap quedo actualizado, 0 si debe recalcularse (el contenido estaba y perdio votos, por lo que
+ * otro que no estaba podria superarlo) o MEM_ERROR si se produjo un error de memoria.
+ */
+static int refreshTop(mediaADT media, TTopHeap ** heap, const TContentId id, const unsigned long oldVotes){
+    size_t pos = *heap == NULL ? 0 : heapFind(*heap, id);
+    if (*heap == NULL || pos == (*heap)->count)
+        return offerTop(media, heap, id);
+    if (COLUMN(media, id, numVotes) < oldVotes)
+        return 0;
+    /// La raiz es el peor, por lo que un contenido que gano votos se aleja de la misma.
+    siftDown(media, *heap, pos);
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que actualiza los heaps de mas votadas de un genero luego de corregir un contenido.
+ */
+static int refreshGenreTop(mediaADT media, TGenre * genre, const TContentId id, const unsigned long oldVotes){
+    int isMovie = COLUMN(media, id, type) == CONTENTTYPE_MOVIE;
+    TTopHeap ** heap = isMovie ? &genre->topMovies : &genre->topSeries;
+    int out = refreshTop(media, heap, id, oldVotes);
+    if (out != 0)
+        return out;
+    (*heap)->count = 0;
+    return offerIds(media, heap, isMovie ? genre->movies : genre->series);
+}
+
+/**
+ * @brief Funcion auxiliar que actualiza los heaps de mas votadas de un año luego de corregir un contenido. Si debe
+ * recalcularse, se recorren los generos del año (un contenido con varios generos se guarda una unica vez).
+ */
+static int refreshYearTop(mediaADT media, TYear year, const TContentId id, const unsigned long oldVotes){
+    int isMovie = COLUMN(media, id, type) == CONTENTTYPE_MOVIE;
+    TTopHeap ** heap = isMovie ? &year->topMovies : &year->topSeries;
+    int out = refreshTop(media, heap, id, oldVotes);
+    if (out != 0)
+        return out;
+    (*heap)->count = 0;
+    if (offerTop(media, heap, id) == MEM_ERROR)
+        return MEM_ERROR;
+    for (size_t i = 0; i < year->genresSize; i++)
+        if (offerIds(media, heap, isMovie ? year->genres[i].movies : year->genres[i].series) == MEM_ERROR)
+            return MEM_ERROR;
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que copia el bloque de columnas de un contenido si lo comparten las versiones publicadas,
+ * para poder corregirlo sin que lo vean los lectores. Las versiones conservan el bloque original.
+ *
+ * @return 1 si el bloque ya no se comparte o MEM_ERROR si se produjo un error de memoria.
+ */
+static int ownChunk(mediaADT media, const TContentId id){
+    const size_t chunk = id / MEM_BLOCK;
+    if (chunk * MEM_BLOCK >= media->sharedContents ||
+        !(media->sharedChunks[chunk / WORD_BITS] & 1ull << (chunk % WORD_BITS)))
+        return 1;
+    const TContentChunk * old = media->contentChunks[chunk];
+    TContentChunk * copy = arenaAlloc(media->arena, sizeof(TContentChunk));
+    CHECK_MEM(copy);
+    memcpy(copy, old, sizeof(TContentChunk));
+    /// Los titulos y los generos se apuntan relativos a su campo, por lo que se vuelven a apuntar desde la copia.
+    size_t count = media->contentsCount - chunk * MEM_BLOCK;
+    for (size_t i = 0; i < count && i < MEM_BLOCK; i++){
+        REL_SET(copy->title[i], REL_GET(old->title[i]));
+        REL_SET(copy->genres[i], REL_GET(old->genres[i]));
+    }
+    media->contentChunks[chunk] = copy;
+    media->sharedChunks[chunk / WORD_BITS] &= ~(1ull << (chunk % WORD_BITS));
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que reemplaza los datos de un contenido ya añadido por los de una fila corregida con la
+ * misma clave (titulo, año y tipo), actualizando sus generos y la mas votada del año.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param id Indice del contenido a corregir.
+ * @param content Fila corregida.
+ * @return 1 si se corrigio correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int correctContent(mediaADT media, const TContentId id, const TRawContent * content){
+    const size_t index = POS(content->startYear, media->baseYear);
+    TYear year = media->years[index];
+    const contentType type = COLUMN(media, id, type);
+    touchYear(year);
+    if (ownChunk(media, id) == MEM_ERROR)
+        return MEM_ERROR;
+    const size_t oldCount = COLUMN(media, id, genresCount);
+    const unsigned long oldVotes = COLUMN(media, id, numVotes);
+    const float oldRating = COLUMN(media, id, averageRating);
+    const unsigned short oldRuntime = COLUMN(media, id, runtimeMinutes);
+    TSlice names[MAX_GENRES];
+    TGenreId genreIds[MAX_GENRES];
+    if (internRowGenres(media, content, names, genreIds, NULL) == MEM_ERROR)
+        return MEM_ERROR;
+    /// Los pares de generos anteriores se descuentan (ya estan en la matriz, por lo que no se reserva memoria).
+    if (countPairs(media, year, GENRES_OF(media, id), oldCount, type, (size_t)0 - 1) == MEM_ERROR)
+        return MEM_ERROR;
+
+    COLUMN(media, id, numVotes) = content->numVotes;
+    COLUMN(media, id, averageRating) = content->averageRating;
+    COLUMN(media, id, endYear) = content->endYear;
+    COLUMN(media, id, runtimeMinutes) = content->runtimeMinutes;
+
+    /// Solo se modifican los generos que difieren entre la version anterior y la corregida.
+    char kept[MAX_GENRES] = {0};
+    TGenreId * oldIds = GENRES_OF(media, id);
+    for (size_t i = 0; i < oldCount; i++){
+        size_t j = 0;
+        while (j < content->genresCount && (kept[j] || genreIds[j] != oldIds[i]))
+            j++;
+        if (j < content->genresCount)
+            kept[j] = 1;
+        else if (oldIds[i] < year->genresSize){
+            TGenre * genre = &year->genres[oldIds[i]];
+            int removed = removeId(media->arena, type == CONTENTTYPE_MOVIE ? &genre->movies : &genre->series, id);
+            if (removed == MEM_ERROR)
+                return MEM_ERROR;
+            if (type == CONTENTTYPE_MOVIE)
+                genre->moviesCount -= removed;
+            else
+                genre->seriesCount -= removed;
+            if (countRange(media, index, oldIds[i], type, (size_t)0 - removed) == MEM_ERROR)
+                return MEM_ERROR;
+            sketchRemove(type == CONTENTTYPE_MOVIE ? genre->moviesSketch : genre->seriesSketch, oldRating, oldRuntime);
+            /// Si estaba entre los mas votados del genero, se vuelven a calcular sin el.
+            TTopHeap ** heap = type == CONTENTTYPE_MOVIE ? &genre->topMovies : &genre->topSeries;
+            if (*heap != NULL && heapFind(*heap, id) < (*heap)->count){
+                (*heap)->count = 0;
+                if (offerIds(media, heap, type == CONTENTTYPE_MOVIE ? genre->movies : genre->series) == MEM_ERROR)
+                    return MEM_ERROR;
+            }
+        }
+    }
+    for (size_t j = 0; j < content->genresCount; j++){
+        if (!kept[j] && (addToGenre(media, year, genreIds[j], names[j], id, type) == MEM_ERROR ||
+                         countRange(media, index, genreIds[j], type, 1) == MEM_ERROR))
+            return MEM_ERROR;
+        if (kept[j]){
+            TGenre * genre = &year->genres[genreIds[j]];
+            if (refreshGenreTop(media, genre, id, oldVotes) == MEM_ERROR)
+                return MEM_ERROR;
+            TQuantileSketch * sketch = type == CONTENTTYPE_MOVIE ? genre->moviesSketch : genre->seriesSketch;
+            sketchRemove(sketch, oldRating, oldRuntime);
+            sketchAdd(sketch, content->averageRating, content->runtimeMinutes);
+        }
+    }
+    if (refreshYearTop(media, year, id, oldVotes) == MEM_ERROR)
+        return MEM_ERROR;
+    TQuantileSketch * sketch = type == CONTENTTYPE_MOVIE ? year->moviesSketch : year->seriesSketch;
+    sketchRemove(sketch, oldRating, oldRuntime);
+    sketchAdd(sketch, content->averageRating, content->runtimeMinutes);
+
+    /// El vector de generos se reutiliza si alcanza y no lo comparten las versiones; si no, se reserva uno nuevo.
+    if (content->genresCount > oldCount || id < media->sharedContents){
+        TGenreId * aux = arenaAlloc(media->arena, sizeof(TGenreId) * content->genresCount);
+        CHECK_MEM(aux);
+        REL_SET(COLUMN(media, id, genres), aux);
+    }
+    memcpy(GENRES_OF(media, id), genreIds, sizeof(TGenreId) * content->genresCount);
+    COLUMN(media, id, genresCount) = content->genresCount;
+    if (countPairs(media, year, genreIds, content->genresCount, type, 1) == MEM_ERROR)
+        return MEM_ERROR;
+
+    updateBest(media, year, id);
+    return 1;
+}
+
+int updateContent( mediaADT media , const TRawContent * content ){
+    /// Sin las filas guardadas no se puede corregir una fila anterior.
+    if (media->mode == MEDIA_AGGREGATE)
+        return RANGE_ERROR;
+    if ( isYearValid(media, content->startYear) == INVALIDYEAR_ERROR)
+        return countRow(media, INVALIDYEAR_ERROR, NULL);
+    if ( content->type != CONTENTTYPE_MOVIE && content->type != CONTENTTYPE_SERIES)
+        return countRow(media, CONTENTTYPE_ERROR, NULL);
+
+    unsigned long long start = statsNow();
+    if (indexContents(media) == MEM_ERROR)
+        return MEM_ERROR;
+    TContentId id = media->keyTable[probeKey(media, media->keyTable, media->keyTableSize, content->primaryTitle,
+                                             content->startYear, content->type)];
+    if (id == 0)
+        return addRawContent(media, content);
+    int out = correctContent(media, id - 1, content);
+    STATS_ADD(media, correctNs, statsNow() - start);
+    return countRow(media, out, &media->stats.rowsCorrected);
+}
+
+size_t countContentByYear(const mediaADT media, const unsigned short year, contentType CONTENTTYPE_ )
+{
+    if (isYearValid(media, year) != SUCCESS || media->years[POS(year, media->baseYear)] == NULL)
+        return 0;
+
+    size_t aux = 0;
+    switch (CONTENTTYPE_) {
+        case CONTENTTYPE_MOVIE:
+            aux = media->years[POS(year, media->baseYear)]->moviesCount;
+            break;
+        case CONTENTTYPE_SERIES:
+            aux = media->years[POS(year, media->baseYear)]->seriesCount;
+            break;
+        default:
+            break;
+    }
+    return aux;
+}
+
+size_t countContentByGenre(const mediaADT media, const unsigned short year, const char * genre ,  contentType CONTENTTYPE_ )
+{
+    if (isYearValid(media, year) != SUCCESS)
+        return 0;
+
+    TYear auxYear = media->years[POS(year, media->baseYear)];
+    TSlice auxSlice = { genre, strlen(genre) };
+    TGenreId genreId = findGenre(&media->dict, auxSlice);
+    if ( auxYear == NULL || genreId == NO_GENRE || genreId >= auxYear->genresSize )
+        return 0;
+    TGenre * auxGenre = &auxYear->genres[genreId];
+
+    size_t aux = 0;
+    switch (CONTENTTYPE_) {
+        case CONTENTTYPE_MOVIE:
+            aux = auxGenre->moviesCount;
+            break;
+        case CONTENTTYPE_SERIES:
+            aux = auxGenre->seriesCount;
+            break;
+        default:
+            break;
+    }
+
+    return aux;
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve la cantidad de peliculas/series de un año con dos generos distintos.
+ */
+static size_t pairCount(const TYear year, const TGenreId a, const TGenreId b, const contentType type){
+    TGenreId high = a > b ? a : b;
+    TGenreId low = a > b ? b : a;
+    if (high >= year->pairsGenres)
+        return 0;
+    return year->pairs[2 * PAIR_POS(high, low) + (type - CONTENTTYPE_MOVIE)];
+}
+
+size_t countContentByGenrePair(const mediaADT media, const unsigned short year, const char * genre,
+                               const char * pairedGenre, contentType CONTENTTYPE_)
+{
+    if (isYearValid(media, year) != SUCCESS || (CONTENTTYPE_ != CONTENTTYPE_MOVIE && CONTENTTYPE_ != CONTENTTYPE_SERIES))
+        return 0;
+
+    TYear auxYear = media->years[POS(year, media->baseYear)];
+    TSlice first = { genre, strlen(genre) };
+    TSlice second = { pairedGenre, strlen(pairedGenre) };
+    TGenreId firstId = findGenre(&media->dict, first);
+    TGenreId secondId = findGenre(&media->dict, second);
+    if (auxYear == NULL || firstId == NO_GENRE || secondId == NO_GENRE)
+        return 0;
+    /// La matriz no guarda la diagonal: un genero junto a si mismo son las peliculas/series del genero.
+    if (firstId == secondId)
+        return countContentByGenre(media, year, genre, CONTENTTYPE_);
+    return pairCount(auxYear, firstId, secondId, CONTENTTYPE_);
+}
+
+size_t topGenrePairs(const mediaADT media, const unsigned short year, const contentType type, TGenrePair * pairs,
+                     const size_t max){
+    if (isYearValid(media, year) != SUCCESS || (type != CONTENTTYPE_MOVIE && type != CONTENTTYPE_SERIES) || max == 0)
+        return 0;
+    TYear auxYear = media->years[POS(year, media->baseYear)];
+    if (auxYear == NULL)
+        return 0;
+
+    /// Los pares se recorren en orden alfabetico y se insertan en orden, desplazando solo a los de menor cantidad,
+    /// por lo que ante igual cantidad queda primero el anterior alfabeticamente.
+    size_t count = 0;
+    for (size_t i = 0; i < media->dict.count; i++){
+        TGenreId genre = media->dict.order[i];
+        for (size_t j = i + 1; j < media->dict.count; j++){
+            TGenreId paired = media->dict.order[j];
+            size_t n = pairCount(auxYear, genre, paired, type);
+            if (n == 0 || (count == max && n <= pairs[max - 1].count))
+                continue;
+            size_t pos = count < max ? count++ : max - 1;
+            for (; pos > 0 && pairs[pos - 1].count < n; pos--)
+                pairs[pos] = pairs[pos - 1];
+            pairs[pos].genre = auxYear->genres[genre].name;
+            pairs[pos].pairedGenre = auxYear->genres[paired].name;
+            pairs[pos].count = n;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Funcion auxiliar que suma en el arbol de un genero (o del total, con NO_GENRE) las cantidades de los años
+ * [from, to], limitados a los años que cubre el TAD.
+ */
+static size_t countYears(const mediaADT media, const unsigned short from, const unsigned short to,
+                         const TGenreId genre, const contentType type){
+    if ((type != CONTENTTYPE_MOVIE && type != CONTENTTYPE_SERIES) || media->rangeTrees == NULL || from > to ||
+        to < media->baseYear)
+        return 0;
+    size_t low = from > media->baseYear ? POS(from, media->baseYear) : 0;
+    size_t high = POS(to, media->baseYear);
+    if (high >= media->rangeYears)
+        high = media->rangeYears - 1;
+    if (low > high)
+        return 0;
+    return fenwickRange(rangeTree(media, genre, type), low, high);
+}
+
+size_t countContentByYearRange(const mediaADT media, const unsigned short from, const unsigned short to,
+                               const contentType type){
+    return countYears(media, from, to, NO_GENRE, type);
+}
+
+size_t countContentByGenreRange(const mediaADT media, const unsigned short from, const unsigned short to,
+                                const char * genre, const contentType type){
+    TSlice slice = { genre, strlen(genre) };
+    TGenreId genreId = findGenre(&media->dict, slice);
+    if (genreId == NO_GENRE || genreId >= media->rangeGenres)
+        return 0;
+    return countYears(media, from, to, genreId, type);
+}
+
+TContent mostVoted(const mediaADT media, const unsigned short year, const contentType CONTENTTYPE_){
+
+    /**
+     * Se crea un struct vacío, el cual la función retornará en caso de error
+     *
+     * @see mediaADT.h
+     */
+    TContent mostVotedContent  = {0};
+
+    /// Se verifica si el año es valido y tiene contenido
+    if (isYearValid(media, year) != SUCCESS || media->years[POS(year, media->baseYear)] == NULL)
+        return mostVotedContent;
+
+    TYear aux = media->years[POS(year, media->baseYear)];
+
+    /// Se verifica de que tipo de contenido se desea obtener el más votado. Si ninguno obtuvo votos, no hay más votado.
+    switch (CONTENTTYPE_) {
+        case CONTENTTYPE_MOVIE:
+            if (aux->bestMovieRating > 0)
+                mostVotedContent = recordToContent(media, aux->bestMovie);
+            break;
+        case CONTENTTYPE_SERIES:
+            if (aux->bestSeriesRating > 0)
+                mostVotedContent = recordToContent(media, aux->bestSeries);
+            break;
+        default:
+            break;
+    }
+
+    return mostVotedContent;
+}
+
+/**
+ * @brief Funcion auxiliar de iterador que coloca al cursor en el siguiente año ocupado/valido (en orden descendente).
+ *
+ * @details Se recorre el mapa de años ocupados de a palabras: el mayor bit encendido de la primera palabra no nula es
+ * el siguiente año, por lo que los años vacios no se visitan.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param cursor Cursor a actualizar. Si no quedan años ocupados, su indice queda en media->size.
+ * @param below Se busca el mayor año ocupado con indice menor a "below".
+ */
+static void nextOcuppiedYear(const mediaADT media, TYearCursor * cursor, const size_t below) {
+    size_t word = below / WORD_BITS;
+    /// En la palabra de "below" solo se consideran las posiciones anteriores.
+    unsigned long long bits = below % WORD_BITS == 0 ? 0 : media->occupied[word] & ((1ull << (below % WORD_BITS)) - 1);
+    while (bits == 0 && word > 0)
+        bits = media->occupied[--word];
+    cursor->index = bits == 0 ? media->size : word * WORD_BITS + (WORD_BITS - 1 - __builtin_clzll(bits));
+}
+
+void toBeginYearCursor(const mediaADT media, TYearCursor * cursor){
+    /// Se busca el ultimo año ocupado.
+    nextOcuppiedYear(media, cursor, media->size);
+}
+
+int hasNextYearCursor(const mediaADT media, const TYearCursor * cursor){
+    /// La iteración se realizará siempre y cuando se esté dentro del rango correspondiente
+    return cursor->index < media->size;
+}
+
+unsigned short nextYearCursor(const mediaADT media, TYearCursor * cursor){
+
+    /**
+     * Si no quedan años validos por recorrer, la función devuelve RANGE_ERROR. El cual podrá ser manejado
+     * desde el frontend.
+     *
+     * @see mediaADT.h
+     */
+
+    if (!hasNextYearCursor(media, cursor)){
+        return RANGE_ERROR;
+    }
+
+    /// Se obtiene el año actual
+    unsigned short year = YEAR(cursor->index, media->baseYear);
+
+    ///Se busca el siguiente año valido antes de la posicion actual
+    nextOcuppiedYear(media, cursor, cursor->index);
+    return year;
+}
+
+void toBeginYear(const mediaADT media){
+    toBeginYearCursor(media, &media->yearCursor);
+}
+
+int hasNextYear(const mediaADT media){
+    return hasNextYearCursor(media, &media->yearCursor);
+}
+
+unsigned short nextYear(const mediaADT media){
+    return nextYearCursor(media, &media->yearCursor);
+}
+
+int toBeginGenreCursor(const mediaADT media, TGenreCursor * cursor, const unsigned short year)
+{
+    /// Se verifica que el año sea valido
+    if (isYearValid(media,year) != SUCCESS )
+        return INVALIDYEAR_ERROR;
+
+    TYear aux = media->years[POS(year,media->baseYear)];
+    /// Se verifica que el año pedido tenga contenido
+    CHECK_MEM(aux)
+
+    /// Se recorre la permutacion alfabetica del diccionario, salteando los generos sin contenido en el año.
+    cursor->year = aux;
+    cursor->position = 0;
+    return 1;
+}
+
+/**
+ * @brief Funcion auxiliar que indica si un genero tiene contenido en un año.
+ *
+ * @param year Año a consultar.
+ * @param id Identificador del genero.
+ */
+static int hasGenre(const TYear year, const TGenreId id){
+    /// Un genero puede quedar sin contenido si se corrigieron los generos de sus peliculas/series.
+    return id < year->genresSize && year->genres[id].name != NULL &&
+           year->genres[id].moviesCount + year->genres[id].seriesCount > 0;
+}
+
+int hasNextGenreCursor(const mediaADT media, TGenreCursor * cursor)
+{
+    if (cursor->year == NULL)
+        return 0;
+    while (cursor->position < media->dict.count &&
+           !hasGenre((TYear)cursor->year, media->dict.order[cursor->position]))
+        cursor->position++;
+    return cursor->position < media->dict.count;
+}
+
+char * nextGenreCursor(const mediaADT media, TGenreCursor * cursor)
+{
+    if ( !hasNextGenreCursor(media, cursor) )
+        return NULL;
+    return (char *)cursor->year->genres[media->dict.order[cursor->position++]].name;
+}
+
+int toBeginGenre (const mediaADT media , const unsigned short year )
+{
+    return toBeginGenreCursor(media, &media->genreCursor, year);
+}
+
+int hasNextGenre ( const mediaADT media )
+{
+    return hasNextGenreCursor(media, &media->genreCursor);
+}
+
+char * nextGenre ( const mediaADT media )
+{
+    return nextGenreCursor(media, &media->genreCursor);
+}
+
+int toBeginTopCursor(const mediaADT media, TTopCursor * cursor, const unsigned short year, const char * genre,
+                     const contentType type){
+    if (isYearValid(media, year) != SUCCESS)
+        return INVALIDYEAR_ERROR;
+    if (type != CONTENTTYPE_MOVIE && type != CONTENTTYPE_SERIES)
+        return CONTENTTYPE_ERROR;
+
+    TYear aux = media->years[POS(year, media->baseYear)];
+    const TTopHeap * heap = NULL;
+    if (aux == NULL)
+        heap = NULL;
+    else if (genre == NULL)
+        heap = type == CONTENTTYPE_MOVIE ? aux->topMovies : aux->topSeries;
+    else {
+        TSlice auxSlice = { genre, strlen(genre) };
+        TGenreId genreId = findGenre(&media->dict, auxSlice);
+        if (genreId != NO_GENRE && hasGenre(aux, genreId))
+            heap = type == CONTENTTYPE_MOVIE ? aux->genres[genreId].topMovies : aux->genres[genreId].topSeries;
+    }
+
+    /// Se copia el heap y se ordena de mayor a menor por insercion (a lo sumo MAX_TOP_K indices).
+    cursor->count = heap == NULL ? 0 : heap->count;
+    for (size_t i = 0; i < cursor->count; i++){
+        TContentId id = heap->ids[i];
+        size_t j = i;
+        for (; j > 0 && ranksBelow(media, cursor->ids[j - 1], id); j--)
+            cursor->ids[j] = cursor->ids[j - 1];
+        cursor->ids[j] = id;
+    }
+    cursor->position = 0;
+    return 1;
+}
+
+int hasNextTopCursor(const TTopCursor * cursor){
+    return cursor->position < cursor->count;
+}
+
+TContent nextTopCursor(const mediaADT media, TTopCursor * cursor){
+    TContent content = {0};
+    if (hasNextTopCursor(cursor))
+        content = recordToContent(media, cursor->ids[cursor->position++]);
+    return content;
+}
+
+int toBeginTop(const mediaADT media, const unsigned short year, const char * genre, const contentType type){
+    return toBeginTopCursor(media, &media->topCursor, year, genre, type);
+}
+
+int hasNextTop(const mediaADT media){
+    return hasNextTopCursor(&media->topCursor);
+}
+
+TContent nextTop(const mediaADT media){
+    return nextTopCursor(media, &media->topCursor);
+}
+
+/**
+ * @brief Funcion auxiliar que acumula en "out" el sketch de cuantiles de las peliculas o series indicadas.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año a considerar, o 0 para todos los años.
+ * @param genre Genero a considerar, o NULL para todos los generos.
+ * @param type Tipo de contenido.
+ * @param out Sketch en el que se acumula (debe comenzar vacio).
+ */
+static void collectSketch(const mediaADT media, const unsigned short year, const char * genre, const contentType type,
+                          TQuantileSketch * out){
+    TGenreId genreId = NO_GENRE;
+    if (genre != NULL){
+        TSlice auxSlice = { genre, strlen(genre) };
+        if ((genreId = findGenre(&media->dict, auxSlice)) == NO_GENRE)
+            return;
+    }
+    for (size_t i = 0; i < media->size; i++){
+        TYear aux = media->years[i];
+        if (aux == NULL || (year != 0 && YEAR(i, media->baseYear) != year))
+            continue;
+        const TQuantileSketch * sketch;
+        if (genre == NULL)
+            sketch = type == CONTENTTYPE_MOVIE ? aux->moviesSketch : aux->seriesSketch;
+        else if (genreId < aux->genresSize)
+            sketch = type == CONTENTTYPE_MOVIE ? aux->genres[genreId].moviesSketch : aux->genres[genreId].seriesSketch;
+        else
+            sketch = NULL;
+        if (sketch != NULL)
+            sketchMerge(out, sketch);
+    }
+}
+
+double ratingQuantile(const mediaADT media, const unsigned short year, const char * genre, const contentType type,
+                      const double q){
+    if (type != CONTENTTYPE_MOVIE && type != CONTENTTYPE_SERIES)
+        return -1;
+    TQuantileSketch sketch = {0};
+    collectSketch(media, year, genre, type, &sketch);
+    return sketchRatingQuantile(&sketch, q);
+}
+
+double runtimeQuantile(const mediaADT media, const unsigned short year, const char * genre, const contentType type,
+                       const double q){
+    if (type != CONTENTTYPE_MOVIE && type != CONTENTTYPE_SERIES)
+        return -1;
+    TQuantileSketch sketch = {0};
+    collectSketch(media, year, genre, type, &sketch);
+    return sketchRuntimeQuantile(&sketch, q);
+}
+
+/**
+ * @brief Consulta de agregacion sobre una columna: acumula el agregado y, si "ranged" es 1, la cantidad de valores
+ * dentro de [min, max].
+ */
+typedef struct columnQuery {
+    contentField field;           /**< Campo a recorrer                                  */
+    int ranged;                   /**< 1 si se cuentan valores en rango, 0 si se agrega   */
+    double min;                   /**< Extremo inferior del rango                        */
+    double max;                   /**< Extremo superior del rango                        */
+    TAggregate result;            /**< Agregado acumulado                                */
+    size_t matches;               /**< Cantidad de valores en el rango                   */
+} TColumnQuery;
+
+/**
+ * @brief Valores de una columna copiados desde posiciones no contiguas del almacen central.
+ */
+typedef union columnBuffer {
+    unsigned long u64[MEM_BLOCK];
+    unsigned short u16[MEM_BLOCK];
+    float f32[MEM_BLOCK];
+} TColumnBuffer;
+
+/**
+ * @brief Funcion auxiliar que convierte un extremo de un rango en el entero sin signo mas cercano dentro del mismo.
+ *
+ * @param bound Extremo del rango.
+ * @param top Maximo valor representable en la columna.
+ * @param lower 1 si es el extremo inferior (se redondea hacia arriba), 0 si es el superior (hacia abajo).
+ */
+static unsigned long clampBound(const double bound, const unsigned long top, const int lower){
+    if (bound <= 0)
+        return 0;
+    if (bound >= (double)top)
+        return top;
+    unsigned long aux = (unsigned long)bound;
+    return lower && (double)aux < bound ? aux + 1 : aux;
+}
+
+/**
+ * @brief Funcion auxiliar que aplica el kernel correspondiente al campo de la consulta sobre una porcion de columna.
+ *
+ * @param query Consulta.
+ * @param values Comienzo de los valores (del tipo de la columna del campo).
+ * @param mask Mascara de valores a considerar.
+ * @param n Cantidad de valores.
+ */
+static void runKernel(TColumnQuery * query, const void * values, const unsigned char * mask, const size_t n){
+    /// Un rango vacio o fuera del dominio de los campos (todos no negativos) no contiene valores.
+    if (query->ranged && (query->max < query->min || query->max < 0))
+        return;
+    switch (query->field){
+        case FIELD_NUMVOTES:
+            if (query->ranged)
+                query->matches += countRangeU64(values, mask, n, clampBound(query->min, ULONG_MAX, 1),
+                                                clampBound(query->max, ULONG_MAX, 0));
+            else
+                aggregateU64(values, mask, n, &query->result);
+            break;
+        case FIELD_RATING:
+            if (query->ranged)
+                query->matches += countRangeF32(values, mask, n, query->min, query->max);
+            else
+                aggregateF32(values, mask, n, &query->result);
+            break;
+        default:
+            if (query->ranged)
+                query->matches += countRangeU16(values, mask, n, clampBound(query->min, USHRT_MAX, 1),
+                                                clampBound(query->max, USHRT_MAX, 0));
+            else
+                aggregateU16(values, mask, n, &query->result);
+            break;
+    }
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve el comienzo de la columna de un campo dentro de un bloque del almacen central.
+ */
+static const void * chunkColumn(const TContentChunk * chunk, const contentField field){
+    switch (field){
+        case FIELD_NUMVOTES:
+            return chunk->numVotes;
+        case FIELD_RATING:
+            return chunk->averageRating;
+        case FIELD_RUNTIME:
+            return chunk->runtimeMinutes;
+        case FIELD_STARTYEAR:
+            return chunk->startYear;
+        default:
+            return chunk->endYear;
+    }
+}
+
+/**
+ * @brief Funcion auxiliar que recorre una lista de bloques de indices, copiando el campo de cada contenido a un
+ * vector contiguo para aplicar el kernel.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param query Consulta.
+ * @param block Primer bloque de la lista.
+ */
+static void scanIds(const mediaADT media, TColumnQuery * query, const TIdBlock * block){
+    TColumnBuffer buffer;
+    unsigned char mask[MEM_BLOCK];
+    memset(mask, 1, sizeof(mask));
+    for (; block != NULL; block = block->next){
+        for (size_t i = 0; i < block->count; i++){
+            TContentId id = block->ids[i];
+            switch (query->field){
+                case FIELD_NUMVOTES:
+                    buffer.u64[i] = COLUMN(media, id, numVotes);
+                    break;
+                case FIELD_RATING:
+                    buffer.f32[i] = COLUMN(media, id, averageRating);
+                    break;
+                default:
+                    buffer.u16[i] = ((const unsigned short *)chunkColumn(media->contentChunks[id / MEM_BLOCK],
+                                                                         query->field))[id % MEM_BLOCK];
+                    break;
+            }
+        }
+        runKernel(query, &buffer, mask, block->count);
+    }
+}
+
+/**
+ * @brief Funcion auxiliar que ejecuta una consulta sobre los contenidos de un tipo, año y genero.
+ *
+ * @details Sin genero, se recorren las columnas completas del almacen central filtrando por tipo (y por año, si se
+ * indica) mediante mascaras. Con genero, se recorren los indices del genero en el año (o en cada año).
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año de comienzo, o 0 para todos los años.
+ * @param genre Genero, o NULL para todos los generos.
+ * @param type Tipo de contenido.
+ * @param query Consulta a ejecutar.
+ */
+static void scanContent(const mediaADT media, const unsigned short year, const char * genre, const contentType type,
+                        TColumnQuery * query){
+    if (genre == NULL){
+        unsigned char mask[MEM_BLOCK];
+        for (size_t base = 0; base < media->contentsCount; base += MEM_BLOCK){
+            const TContentChunk * chunk = media->contentChunks[base / MEM_BLOCK];
+            size_t n = media->contentsCount - base < MEM_BLOCK ? media->contentsCount - base : MEM_BLOCK;
+            maskEquals8(chunk->type, type, mask, n);
+            if (year != 0)
+                maskAndEquals16(chunk->startYear, year, mask, n);
+            runKernel(query, chunkColumn(chunk, query->field), mask, n);
+        }
+        return;
+    }
+
+    TSlice auxSlice = { genre, strlen(genre) };
+    TGenreId genreId = findGenre(&media->dict, auxSlice);
+    if (genreId == NO_GENRE)
+        return;
+    for (size_t i = 0; i < media->size; i++){
+        TYear aux = media->years[i];
+        if (aux == NULL || (year != 0 && YEAR(i, media->baseYear) != year) || !hasGenre(aux, genreId))
+            continue;
+        scanIds(media, query, type == CONTENTTYPE_MOVIE ? aux->genres[genreId].movies : aux->genres[genreId].series);
+    }
+}
+
+int aggregateContent(const mediaADT media, const unsigned short year, const char * genre, const contentType type,
+                     const contentField field, TAggregate * out){
+    memset(out, 0, sizeof(*out));
+    if (type != CONTENTTYPE_MOVIE && type != CONTENTTYPE_SERIES)
+        return CONTENTTYPE_ERROR;
+    if (media->mode == MEDIA_AGGREGATE)
+        return RANGE_ERROR;
+    TColumnQuery query = { field, 0, 0, 0, {0}, 0 };
+    scanContent(media, year, genre, type, &query);
+    *out = query.result;
+    return 1;
+}
+
+size_t countContentIf(const mediaADT media, const unsigned short year, const char * genre, const contentType type,
+                      const contentField field, const double min, const double max){
+    /// En modo MEDIA_AGGREGATE el almacen solo tiene las copias de las mas votadas de cada año, que no se cuentan.
+    if ((type != CONTENTTYPE_MOVIE && type != CONTENTTYPE_SERIES) || media->mode == MEDIA_AGGREGATE)
+        return 0;
+    TColumnQuery query = { field, 1, min, max, {0}, 0 };
+    scanContent(media, year, genre, type, &query);
+    return query.matches;
+}
+
+/**
+ * @brief Funcion auxiliar que reserva "len" bytes alineados en el snapshot y copia "data" si no es NULL.
+ *
+ * @param writer Escritor del snapshot.
+ * @param data Datos a copiar (NULL para solo reservar el espacio).
+ * @param len Cantidad de bytes.
+ * @return Desplazamiento de los datos dentro del archivo.
+ */
+static size_t snapshotPut(TSnapshotWriter * writer, const void * data, const size_t len){
+    size_t offset = (writer->pos + SNAPSHOT_ALIGN - 1) & ~((size_t)SNAPSHOT_ALIGN - 1);
+    if (writer->base != NULL && data != NULL)
+        memcpy(writer->base + offset, data, len);
+    writer->pos = offset + len;
+    return offset;
+}
+
+/**
+ * @brief Funcion auxiliar que guarda en el snapshot una lista de bloques de indices como un unico bloque.
+ *
+ * @param writer Escritor del snapshot.
+ * @param first Primer bloque de la lista (el mas reciente).
+ * @param count Cantidad total de indices de la lista.
+ * @return Desplazamiento del bloque o 0 si la lista esta vacia.
+ */
+static size_t snapshotIds(TSnapshotWriter * writer, const TIdBlock * first, const size_t count){
+    if (count == 0)
+        return 0;
+    size_t offset = snapshotPut(writer, NULL, sizeof(TIdBlock) + count * sizeof(TContentId));
+    if (writer->base != NULL){
+        TIdBlock * block = (TIdBlock *)(writer->base + offset);
+        block->next = NULL;
+        block->capacity = block->count = count;
+        block->shared = 0;
+        /// Los bloques guardan primero al mas reciente, por lo que se copian desde el final.
+        size_t pos = count;
+        for (const TIdBlock * aux = first; aux != NULL; aux = aux->next){
+            pos -= aux->count;
+            memcpy(block->ids + pos, aux->ids, aux->count * sizeof(TContentId));
+        }
+    }
+    return offset;
+}
+
+/**
+ * @brief Funcion auxiliar que guarda en el snapshot un heap de mas votadas con toda su capacidad, para poder seguir
+ * añadiendo luego de cargar.
+ *
+ * @param writer Escritor del snapshot.
+ * @param heap Heap a guardar.
+ * @param topK Capacidad del heap.
+ * @return Desplazamiento del heap o 0 si no tiene indices.
+ */
+static size_t snapshotTop(TSnapshotWriter * writer, const TTopHeap * heap, const size_t topK){
+    if (heap == NULL)
+        return 0;
+    size_t offset = snapshotPut(writer, NULL, sizeof(TTopHeap) + topK * sizeof(TContentId));
+    if (writer->base != NULL)
+        memcpy(writer->base + offset, heap, sizeof(TTopHeap) + heap->count * sizeof(TContentId));
+    return offset;
+}
+
+/**
+ * @brief Funcion auxiliar que guarda en el snapshot un sketch de cuantiles.
+ *
+ * @return Desplazamiento del sketch o 0 si no existe.
+ */
+static size_t snapshotSketch(TSnapshotWriter * writer, const TQuantileSketch * sketch){
+    return sketch == NULL ? 0 : snapshotPut(writer, sketch, sizeof(TQuantileSketch));
+}
+
+/**
+ * @brief Funcion auxiliar que guarda en el snapshot un año con su tabla de generos.
+ *
+ * @param writer Escritor del snapshot.
+ * @param year Año a guardar.
+ * @return Desplazamiento del struct year.
+ */
+static size_t snapshotYear(TSnapshotWriter * writer, const TYear year, const size_t topK){
+    size_t yearOffset = snapshotPut(writer, year, sizeof(struct year));
+    size_t tableOffset = snapshotPut(writer, year->genres, sizeof(TGenre) * year->genresSize);
+    size_t topMovies = snapshotTop(writer, year->topMovies, topK);
+    size_t topSeries = snapshotTop(writer, year->topSeries, topK);
+    size_t moviesSketch = snapshotSketch(writer, year->moviesSketch);
+    size_t seriesSketch = snapshotSketch(writer, year->seriesSketch);
+    size_t pairs = snapshotPut(writer, year->pairs, sizeof(size_t) * PAIR_SLOTS(year->pairsGenres));
+    if (writer->base != NULL){
+        TYear out = (TYear)(writer->base + yearOffset);
+        out->genres = (TGenre *)(uintptr_t)tableOffset;
+        out->pairs = year->pairsGenres == 0 ? NULL : (size_t *)(uintptr_t)pairs;
+        out->topMovies = (TTopHeap *)(uintptr_t)topMovies;
+        out->topSeries = (TTopHeap *)(uintptr_t)topSeries;
+        out->moviesSketch = (TQuantileSketch *)(uintptr_t)moviesSketch;
+        out->seriesSketch = (TQuantileSketch *)(uintptr_t)seriesSketch;
+        out->frozen = NULL;
+    }
+
+    for (size_t i = 0; i < year->genresSize; i++){
+        const TGenre * genre = &year->genres[i];
+        if (genre->name == NULL)
+            continue;
+        size_t name = snapshotPut(writer, genre->name, strlen(genre->name) + 1);
+        size_t movies = snapshotIds(writer, genre->movies, genre->moviesCount);
+        size_t series = snapshotIds(writer, genre->series, genre->seriesCount);
+        topMovies = snapshotTop(writer, genre->topMovies, topK);
+        topSeries = snapshotTop(writer, genre->topSeries, topK);
+        moviesSketch = snapshotSketch(writer, genre->moviesSketch);
+        seriesSketch = snapshotSketch(writer, genre->seriesSketch);
+        if (writer->base != NULL){
+            TGenre * out = (TGenre *)(writer->base + tableOffset) + i;
+            out->name = (const char *)(uintptr_t)name;
+            out->movies = (TIdBlock *)(uintptr_t)movies;
+            out->series = (TIdBlock *)(uintptr_t)series;
+            out->topMovies = (TTopHeap *)(uintptr_t)topMovies;
+            out->topSeries = (TTopHeap *)(uintptr_t)topSeries;
+            out->moviesSketch = (TQuantileSketch *)(uintptr_t)moviesSketch;
+            out->seriesSketch = (TQuantileSketch *)(uintptr_t)seriesSketch;
+        }
+    }
+    return yearOffset;
+}
+
+/**
+ * @brief Funcion auxiliar que guarda en el snapshot todo el contenido del TAD.
+ *
+ * @param media ADT a guardar.
+ * @param writer Escritor del snapshot.
+ * @param header Encabezado a completar con los desplazamientos de cada seccion.
+ */
+static void snapshotWrite(const mediaADT media, TSnapshotWriter * writer, TSnapshotHeader * header){
+    writer->pos = sizeof(TSnapshotHeader);
+
+    header->yearsOffset = snapshotPut(writer, NULL, sizeof(unsigned long) * media->size);
+    for (size_t i = 0; i < media->size; i++){
+        unsigned long offset = media->years[i] == NULL ? 0 : snapshotYear(writer, media->years[i], media->topK);
+        if (writer->base != NULL)
+            ((unsigned long *)(writer->base + header->yearsOffset))[i] = offset;
+    }
+
+    /// Cada genero del diccionario se guarda como la cantidad de formas de escribirlo seguida de las mismas.
+    header->dictOffset = snapshotPut(writer, NULL, sizeof(unsigned long) * media->dict.count);
+    for (size_t i = 0; i < media->dict.count; i++){
+        unsigned long count = 0;
+        for (const TSpelling * aux = media->dict.names[i]; aux != NULL; aux = aux->next)
+            count++;
+        size_t offset = snapshotPut(writer, &count, sizeof(count));
+        for (const TSpelling * aux = media->dict.names[i]; aux != NULL; aux = aux->next)
+            snapshotPut(writer, aux->name, strlen(aux->name) + 1);
+        if (writer->base != NULL)
+            ((unsigned long *)(writer->base + header->dictOffset))[i] = offset;
+    }
+
+    /// Los bloques de columnas se guardan contiguos y completos, para poder seguir añadiendo luego de cargar.
+    size_t chunks = (media->contentsCount + MEM_BLOCK - 1) / MEM_BLOCK;
+    header->recordsOffset = snapshotPut(writer, NULL, sizeof(TContentChunk) * chunks);
+    TContentChunk * records = writer->base == NULL ? NULL : (TContentChunk *)(writer->base + header->recordsOffset);
+    if (records != NULL)
+        for (size_t i = 0; i < chunks; i++)
+            records[i] = *media->contentChunks[i];
+    for (TContentId id = 0; id < media->contentsCount; id++){
+        size_t genres = snapshotPut(writer, GENRES_OF(media, id), sizeof(TGenreId) * COLUMN(media, id, genresCount));
+        const char * title = REL_GET(COLUMN(media, id, title));
+        /// En modo MEDIA_AGGREGATE se guarda el titulo completo, para poder seguir sobrescribiendolo luego de cargar.
+        size_t offset = snapshotPut(writer, title, media->mode == MEDIA_AGGREGATE ? MAX_TITLE_SIZE : strlen(title) + 1);
+        if (records != NULL){
+            REL_SET(records[id / MEM_BLOCK].title[id % MEM_BLOCK], writer->base + offset);
+            REL_SET(records[id / MEM_BLOCK].genres[id % MEM_BLOCK], writer->base + genres);
+        }
+    }
+
+    /// La tabla de claves se guarda completa (aunque no se haya armado en memoria), para que las correcciones
+    /// posteriores a la carga no tengan que registrar todos los contenidos. El archivo comienza en cero.
+    if (media->mode == MEDIA_FULL){
+        header->keysSize = keyTableSizeFor(media->contentsCount);
+        header->keysOffset = snapshotPut(writer, NULL, sizeof(TContentId) * header->keysSize);
+        TContentId * keys = writer->base == NULL ? NULL : (TContentId *)(writer->base + header->keysOffset);
+        for (TContentId id = 0; keys != NULL && id < media->contentsCount; id++){
+            TSlice title = { REL_GET(COLUMN(media, id, title)), strlen(REL_GET(COLUMN(media, id, title))) };
+            keys[probeKey(media, keys, header->keysSize, title, COLUMN(media, id, startYear), COLUMN(media, id, type))] =
+                id + 1;
+        }
+    }
+    snapshotPut(writer, NULL, 0);
+}
+
+/**
+ * @brief Funcion auxiliar que calcula la suma de verificacion de una porcion del snapshot, de a 8 bytes.
+ *
+ * @param data Comienzo de la porcion (alineado a 8 bytes).
+ * @param len Longitud de la porcion (multiplo de 8).
+ */
+static unsigned long snapshotChecksum(const char * data, const size_t len){
+    const uint64_t * words = (const uint64_t *)data;
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < len / sizeof(uint64_t); i++){
+        h = (h ^ words[i]) * 1099511628211ULL;
+        h ^= h >> 29;
+    }
+    return (unsigned long)h;
+}
+
+int saveMediaADT(const mediaADT media, const char * filePath){
+    unsigned long long start = statsNow();
+    TSnapshotHeader header = {{0}};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.layout = SNAPSHOT_LAYOUT;
+    header.minYear = media->minYear;
+    header.baseYear = media->baseYear;
+    header.size = media->size;
+    header.dim = media->dim;
+    header.contentsCount = media->contentsCount;
+    header.genresCount = media->dict.count;
+    header.topK = media->topK;
+    header.mode = media->mode;
+
+    /// Primera pasada: se calcula el tamaño del archivo.
+    TSnapshotWriter writer = { NULL, 0 };
+    snapshotWrite(media, &writer, &header);
+    header.fileSize = writer.pos;
+
+    /// Se escribe en un archivo temporal que reemplaza al destino al terminar, para no dejar snapshots incompletos.
+    size_t pathLen = strlen(filePath);
+    char * tmpPath = malloc(pathLen + 5);
+    CHECK_MEM(tmpPath);
+    strcpy(tmpPath, filePath);
+    strcpy(tmpPath + pathLen, ".tmp");
+    int fd = open(tmpPath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1 || ftruncate(fd, header.fileSize) != 0){
+        if (fd != -1)
+            close(fd);
+        free(tmpPath);
+        return SNAPSHOT_ERROR;
+    }
+    writer.base = mmap(NULL, header.fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (writer.base == MAP_FAILED){
+        unlink(tmpPath);
+        free(tmpPath);
+        return SNAPSHOT_ERROR;
+    }
+
+    /// Segunda pasada: se copian los datos.
+    snapshotWrite(media, &writer, &header);
+    header.checksum = snapshotChecksum(writer.base + sizeof(header), header.fileSize - sizeof(header));
+    memcpy(writer.base, &header, sizeof(header));
+    int out = msync(writer.base, header.fileSize, MS_SYNC) == 0 ? 1 : SNAPSHOT_ERROR;
+    munmap(writer.base, header.fileSize);
+    if (out == 1 && rename(tmpPath, filePath) != 0)
+        out = SNAPSHOT_ERROR;
+    if (out != 1)
+        unlink(tmpPath);
+    free(tmpPath);
+    STATS_ADD(media, saveNs, statsNow() - start);
+    return out;
+}
+
+/**
+ * @brief Funcion auxiliar que traduce los desplazamientos de un año del snapshot a punteros dentro del mapeo.
+ *
+ * @param base Comienzo del snapshot mapeado.
+ * @param year Año dentro del snapshot.
+ */
+static void snapshotFixYear(char * base, TYear year){
+    year->genres = (TGenre *)(base + (uintptr_t)year->genres);
+    year->topMovies = year->topMovies == NULL ? NULL : (TTopHeap *)(base + (uintptr_t)year->topMovies);
+    year->topSeries = year->topSeries == NULL ? NULL : (TTopHeap *)(base + (uintptr_t)year->topSeries);
+    year->moviesSketch = year->moviesSketch == NULL ? NULL : (TQuantileSketch *)(base + (uintptr_t)year->moviesSketch);
+    year->seriesSketch = year->seriesSketch == NULL ? NULL : (TQuantileSketch *)(base + (uintptr_t)year->seriesSketch);
+    year->pairs = year->pairs == NULL ? NULL : (size_t *)(base + (uintptr_t)year->pairs);
+    for (size_t i = 0; i < year->genresSize; i++){
+        TGenre * genre = &year->genres[i];
+        if (genre->name == NULL)
+            continue;
+        genre->name = base + (uintptr_t)genre->name;
+        genre->movies = genre->movies == NULL ? NULL : (TIdBlock *)(base + (uintptr_t)genre->movies);
+        genre->series = genre->series == NULL ? NULL : (TIdBlock *)(base + (uintptr_t)genre->series);
+        genre->topMovies = genre->topMovies == NULL ? NULL : (TTopHeap *)(base + (uintptr_t)genre->topMovies);
+        genre->topSeries = genre->topSeries == NULL ? NULL : (TTopHeap *)(base + (uintptr_t)genre->topSeries);
+        genre->moviesSketch = genre->moviesSketch == NULL ? NULL :
+                              (TQuantileSketch *)(base + (uintptr_t)genre->moviesSketch);
+        genre->seriesSketch = genre->seriesSketch == NULL ? NULL :
+                              (TQuantileSketch *)(base + (uintptr_t)genre->seriesSketch);
+    }
+}
+
+/**
+ * @brief Funcion auxiliar que arma las tablas en memoria de un TAD a partir de un snapshot mapeado y validado.
+ *
+ * @param media ADT vacio con el snapshot ya asignado en media->mapping.
+ * @param header Encabezado del snapshot.
+ * @return 1 si se armo correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int snapshotAttach(mediaADT media, const TSnapshotHeader * header){
+    char * base = media->mapping;
+    media->minYear = header->minYear;
+    media->baseYear = header->baseYear;
+    media->dim = header->dim;
+    media->topK = header->topK;
+
+    /// Tabla de años: punteros a los struct year dentro del mapeo.
+    if (header->size > 0){
+        CHECK_MEM(media->years = calloc(header->size, sizeof(TYear)));
+        CHECK_MEM(media->occupied = calloc(BITMAP_WORDS(header->size), sizeof(unsigned long long)));
+        media->size = header->size;
+        const unsigned long * offsets = (const unsigned long *)(base + header->yearsOffset);
+        for (size_t i = 0; i < media->size; i++)
+            if (offsets[i] != 0){
+                media->years[i] = (TYear)(base + offsets[i]);
+                media->occupied[i / WORD_BITS] |= 1ull << (i % WORD_BITS);
+                snapshotFixYear(base, media->years[i]);
+            }
+    }
+
+    /// Almacen central: cada bloque apunta directamente a los registros del mapeo.
+    size_t chunks = (header->contentsCount + MEM_BLOCK - 1) / MEM_BLOCK;
+    if (chunks > 0){
+        CHECK_MEM(media->contentChunks = malloc(sizeof(TContentChunk *) * chunks));
+        for (size_t i = 0; i < chunks; i++)
+            media->contentChunks[i] = (TContentChunk *)(base + header->recordsOffset) + i;
+    }
+    media->chunksCount = chunks;
+    media->contentsCount = header->contentsCount;
+
+    /// La tabla de claves se utiliza dentro del mapeo: ya registra todos los contenidos del snapshot.
+    if (header->keysSize > 0){
+        media->keyTable = (TContentId *)(base + header->keysOffset);
+        media->keyTableSize = header->keysSize;
+        media->keyedCount = header->contentsCount;
+    }
+
+    /// Diccionario: se registran los generos en orden, por lo que conservan sus identificadores.
+    const unsigned long * dict = (const unsigned long *)(base + header->dictOffset);
+    for (size_t i = 0; i < header->genresCount; i++){
+        const char * name = base + dict[i] + sizeof(unsigned long);
+        unsigned long count = *(const unsigned long *)(base + dict[i]);
+        for (unsigned long j = 0; j < count; j++){
+            TSlice slice = { name, strlen(name) };
+            if (j == 0 && internGenre(media, slice) == NO_GENRE)
+                return MEM_ERROR;
+            if (j > 0 && genreSpelling(media->arena, &media->dict, i, slice) == NULL)
+                return MEM_ERROR;
+            name += slice.len + 1;
+        }
+    }
+    /// Los arboles de cantidades por año no se guardan: se arman a partir de las cantidades de cada año y genero.
+    return rebuildRanges(media);
+}
+
+mediaADT loadMediaADT(const char * filePath, arenaADT arena){
+    unsigned long long start = statsNow();
+    int fd = open(filePath, O_RDONLY);
+    if (fd == -1)
+        return NULL;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(TSnapshotHeader)){
+        close(fd);
+        return NULL;
+    }
+    /// El mapeo es privado y con permiso de escritura: los cambios posteriores (por ejemplo, añadir contenido) solo
+    /// copian las paginas modificadas y nunca alteran el archivo.
+    size_t size = (size_t)info.st_size;
+    char * base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return NULL;
+
+    TSnapshotHeader header;
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.version != SNAPSHOT_VERSION ||
+        header.layout != SNAPSHOT_LAYOUT || header.fileSize != size || header.topK < 1 || header.topK > MAX_TOP_K ||
+        header.mode > MEDIA_AGGREGATE || header.baseYear < header.minYear ||
+        (header.keysSize != 0 && ((header.keysSize & (header.keysSize - 1)) != 0 ||
+                                  header.keysSize <= header.contentsCount * 2)) ||
+        header.checksum != snapshotChecksum(base + sizeof(header), size - sizeof(header))){
+        munmap(base, size);
+        return NULL;
+    }
+
+    mediaADT media = newMediaADT(header.minYear, arena, (mediaMode)header.mode);
+    if (media == NULL){
+        munmap(base, size);
+        return NULL;
+    }
+    media->mapping = base;
+    media->mappingSize = size;
+    if (snapshotAttach(media, &header) == MEM_ERROR){
+        freeMediaADT(media);
+        return NULL;
+    }
+    STATS_ADD(media, loadNs, statsNow() - start);
+    return media;
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve la copia de una parte del año ubicada en "offset" dentro del bloque de la
+ * copia inmutable, o "original" si esa parte no se copio (offset 0).
+ */
+static void * frozenPart(char * base, const size_t offset, void * original){
+    return offset == 0 ? original : base + offset;
+}
+
+/**
+ * @brief Funcion auxiliar que copia el primer bloque de una lista de indices si todavia tiene lugar libre. Los
+ * bloques llenos ya no se modifican al añadir contenido, por lo que se comparten con la copia y se marcan como
+ * compartidos: corregir un contenido los copia antes de modificarlos (@see removeId).
+ *
+ * @return Desplazamiento de la copia o 0 si no hizo falta copiar.
+ */
+static size_t freezeIds(TSnapshotWriter * writer, TIdBlock * first){
+    /// Los bloques compartidos quedan al final de la lista, por lo que se marcan hasta encontrar uno ya marcado.
+    for (TIdBlock * block = first; block != NULL && !block->shared; block = block->next)
+        block->shared = block->count == block->capacity;
+    if (first == NULL || first->count == first->capacity)
+        return 0;
+    size_t offset = snapshotPut(writer, first, sizeof(TIdBlock) + first->count * sizeof(TContentId));
+    if (writer->base != NULL)
+        ((TIdBlock *)(writer->base + offset))->capacity = first->count;
+    return offset;
+}
+
+/**
+ * @brief Funcion auxiliar que copia un heap de mas votadas con solo los indices que tiene.
+ *
+ * @return Desplazamiento de la copia o 0 si el heap no existe.
+ */
+static size_t freezeTop(TSnapshotWriter * writer, const TTopHeap * heap){
+    return heap == NULL ? 0 : snapshotTop(writer, heap, heap->count);
+}
+
+/**
+ * @brief Funcion auxiliar que arma la copia inmutable de un año en un unico bloque. Utiliza el escritor de snapshots
+ * en dos pasadas: la primera calcula el tamaño del bloque y la segunda copia los datos.
+ *
+ * @param year Año a copiar.
+ * @return Copia del año con una referencia, o NULL si se produjo un error de memoria.
+ */
+static TFrozenYear * freezeYear(const TYear year){
+    TSnapshotWriter writer = { NULL, 0 };
+    TFrozenYear * frozen = NULL;
+    for (int pass = 0; pass < 2; pass++){
+        writer.pos = 0;
+        snapshotPut(&writer, NULL, sizeof(TFrozenYear));
+        size_t table = snapshotPut(&writer, year->genres, sizeof(TGenre) * year->genresSize);
+        size_t topMovies = freezeTop(&writer, year->topMovies);
+        size_t topSeries = freezeTop(&writer, year->topSeries);
+        size_t moviesSketch = snapshotSketch(&writer, year->moviesSketch);
+        size_t seriesSketch = snapshotSketch(&writer, year->seriesSketch);
+        size_t pairs = snapshotPut(&writer, year->pairs, sizeof(size_t) * PAIR_SLOTS(year->pairsGenres));
+        if (frozen != NULL){
+            TYear out = &frozen->year;
+            out->genres = frozenPart(writer.base, year->genresSize > 0 ? table : 0, NULL);
+            out->pairs = frozenPart(writer.base, year->pairsGenres > 0 ? pairs : 0, NULL);
+            out->topMovies = frozenPart(writer.base, topMovies, NULL);
+            out->topSeries = frozenPart(writer.base, topSeries, NULL);
+            out->moviesSketch = frozenPart(writer.base, moviesSketch, NULL);
+            out->seriesSketch = frozenPart(writer.base, seriesSketch, NULL);
+            /// La copia apunta a si misma, para que la version pueda liberar su referencia.
+            out->frozen = frozen;
+        }
+
+        for (size_t i = 0; i < year->genresSize; i++){
+            TGenre * genre = &year->genres[i];
+            if (genre->name == NULL)
+                continue;
+            size_t movies = freezeIds(&writer, genre->movies);
+            size_t series = freezeIds(&writer, genre->series);
+            topMovies = freezeTop(&writer, genre->topMovies);
+            topSeries = freezeTop(&writer, genre->topSeries);
+            moviesSketch = snapshotSketch(&writer, genre->moviesSketch);
+            seriesSketch = snapshotSketch(&writer, genre->seriesSketch);
+            if (frozen != NULL){
+                TGenre * out = &frozen->year.genres[i];
+                out->movies = frozenPart(writer.base, movies, genre->movies);
+                out->series = frozenPart(writer.base, series, genre->series);
+                out->topMovies = frozenPart(writer.base, topMovies, NULL);
+                out->topSeries = frozenPart(writer.base, topSeries, NULL);
+                out->moviesSketch = frozenPart(writer.base, moviesSketch, NULL);
+                out->seriesSketch = frozenPart(writer.base, seriesSketch, NULL);
+            }
+        }
+
+        if (pass == 0){
+            if ((frozen = malloc(writer.pos)) == NULL)
+                return NULL;
+            frozen->refs = 1;
+            frozen->year = *year;
+            writer.base = (char *)frozen;
+        }
+    }
+    return frozen;
+}
+
+/**
+ * @brief Funcion auxiliar que libera una version publicada: sus tablas y sus referencias a las copias de los años.
+ */
+static void freeVersion(mediaADT version){
+    for (size_t i = 0; version->years != NULL && i < version->size; i++)
+        if (version->years[i] != NULL)
+            releaseFrozen(version->years[i]->frozen);
+    free(version->years);
+    free(version->occupied);
+    free(version->contentChunks);
+    free(version->dict.names);
+    free(version->dict.table);
+    free(version->dict.order);
+    free(version->rangeTrees);
+    free(version);
+}
+
+/**
+ * @brief Funcion auxiliar que libera las versiones reemplazadas que ya no puede estar utilizando ningun lector: las
+ * reemplazadas antes de la menor epoca anunciada por los lectores con una version fijada.
+ *
+ * @param media ADT que publica las versiones.
+ */
+static void reclaimVersions(mediaADT media){
+    unsigned long oldest = __atomic_load_n(&media->epoch, __ATOMIC_SEQ_CST);
+    for (size_t i = 0; i < MAX_READERS; i++){
+        unsigned long epoch = __atomic_load_n(&media->readers[i], __ATOMIC_SEQ_CST);
+        if (epoch != 0 && epoch < oldest)
+            oldest = epoch;
+    }
+    mediaADT * link = &media->retired;
+    while (*link != NULL){
+        mediaADT aux = *link;
+        if (aux->retiredEpoch < oldest){
+            *link = aux->nextRetired;
+            freeVersion(aux);
+        }
+        else
+            link = &aux->nextRetired;
+    }
+}
+
+/**
+ * @brief Funcion auxiliar que copia un vector de "count" elementos de "size" bytes.
+ *
+ * @return Copia del vector, o NULL si el vector esta vacio o se produjo un error de memoria.
+ */
+static void * copyTable(const void * table, const size_t count, const size_t size){
+    if (count == 0)
+        return NULL;
+    void * out = malloc(count * size);
+    if (out != NULL)
+        memcpy(out, table, count * size);
+    return out;
+}
+
+int publishMediaADT(mediaADT media){
+    /// Las mas votadas de cada año se sobrescriben en el lugar, por lo que no pueden compartirse con los lectores.
+    if (media->mode == MEDIA_AGGREGATE)
+        return RANGE_ERROR;
+    mediaADT version = calloc(1, sizeof(mediaCDT));
+    CHECK_MEM(version);
+    version->minYear = media->minYear;
+    version->baseYear = media->baseYear;
+    version->size = media->size;
+    version->dim = media->dim;
+    version->contentsCount = media->contentsCount;
+    version->topK = media->topK;
+    version->dict.count = media->dict.count;
+    version->dict.tableSize = media->dict.tableSize;
+
+    /// Las tablas que el escritor agranda con realloc se copian; los bloques de contenidos y los titulos se comparten
+    /// (corregir un contenido copia antes su bloque, @see ownChunk).
+    size_t chunks = (media->contentsCount + MEM_BLOCK - 1) / MEM_BLOCK;
+    version->years = media->size == 0 ? NULL : calloc(media->size, sizeof(TYear));
+    version->occupied = copyTable(media->occupied, BITMAP_WORDS(media->size), sizeof(unsigned long long));
+    version->contentChunks = copyTable(media->contentChunks, chunks, sizeof(TContentChunk *));
+    version->dict.names = copyTable(media->dict.names, media->dict.count, sizeof(TSpelling *));
+    version->dict.table = copyTable(media->dict.table, media->dict.tableSize, sizeof(TGenreId));
+    version->dict.order = copyTable(media->dict.order, media->dict.count, sizeof(TGenreId));
+    version->rangeYears = media->rangeYears;
+    version->rangeGenres = media->rangeGenres;
+    version->rangeTrees = media->rangeTrees == NULL ? NULL :
+                          copyTable(media->rangeTrees, (media->rangeGenres + 1) * 2 * (media->rangeYears + 1), sizeof(size_t));
+    if ((media->rangeTrees != NULL && version->rangeTrees == NULL) ||
+        (media->size > 0 && (version->years == NULL || version->occupied == NULL)) ||
+        (chunks > 0 && version->contentChunks == NULL) ||
+        (media->dict.count > 0 && (version->dict.names == NULL || version->dict.order == NULL)) ||
+        (media->dict.tableSize > 0 && version->dict.table == NULL)){
+        freeVersion(version);
+        return MEM_ERROR;
+    }
+
+    /// Solo se copian los años modificados desde la publicacion anterior; el resto comparte su copia.
+    for (size_t i = 0; i < media->size; i++){
+        TYear year = media->years[i];
+        if (year == NULL)
+            continue;
+        if (year->frozen == NULL && (year->frozen = freezeYear(year)) == NULL){
+            freeVersion(version);
+            return MEM_ERROR;
+        }
+        year->frozen->refs++;
+        version->years[i] = &year->frozen->year;
+    }
+
+    /// Los bloques de contenidos existentes pasan a compartirse: corregir un contenido copia antes su bloque.
+    if (chunks > 0){
+        unsigned long long * shared = realloc(media->sharedChunks, sizeof(unsigned long long) * BITMAP_WORDS(chunks));
+        if (shared == NULL){
+            freeVersion(version);
+            return MEM_ERROR;
+        }
+        media->sharedChunks = shared;
+        memset(shared, 0xff, sizeof(unsigned long long) * BITMAP_WORDS(chunks));
+    }
+    media->sharedContents = media->contentsCount;
+
+    /// La version anterior se retira con la epoca vigente y la epoca avanza: los lectores que la fijaron anunciaron
+    /// una epoca menor o igual, y los que anuncien una mayor ya encontraran la nueva version.
+    mediaADT old = media->current;
+    __atomic_store_n(&media->current, version, __ATOMIC_SEQ_CST);
+    if (old != NULL){
+        old->retiredEpoch = __atomic_fetch_add(&media->epoch, 1, __ATOMIC_SEQ_CST);
+        old->nextRetired = media->retired;
+        media->retired = old;
+    }
+    reclaimVersions(media);
+    return 1;
+}
+
+int pinMediaADT(mediaADT media, TMediaPin * pin){
+    /// El lector anuncia la epoca antes de leer la version, para que el escritor no la libere mientras la utiliza.
+    unsigned long epoch = __atomic_load_n(&media->epoch, __ATOMIC_SEQ_CST);
+    for (size_t i = 0; i < MAX_READERS; i++){
+        unsigned long expected = 0;
+        if (__atomic_compare_exchange_n(&media->readers[i], &expected, epoch, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)){
+            pin->slot = i;
+            pin->version = __atomic_load_n(&media->current, __ATOMIC_SEQ_CST);
+            if (pin->version == NULL){
+                unpinMediaADT(media, pin);
+                return RANGE_ERROR;
+            }
+            return 1;
+        }
+    }
+    return RANGE_ERROR;
+}
+
+void unpinMediaADT(mediaADT media, TMediaPin * pin){
+    __atomic_store_n(&media->readers[pin->slot], 0, __ATOMIC_SEQ_CST);
+    pin->version = NULL;
+}
+
+int getMediaStats(const mediaADT media, TMediaStats * stats){
+#ifndef MEDIA_NO_STATS
+    *stats = media->stats;
+    /// Las reservas de los TAD combinados ya estan sumadas; se agregan las del arena propio al momento de la consulta.
+    if (media->arena != NULL){
+        stats->arenaAllocs += arenaAllocations(media->arena);
+        stats->arenaBytes += arenaUsed(media->arena);
+    }
+    stats->meanGenreProbes = stats->genreLookups == 0 ? 0 : (double)stats->genreProbes / stats->genreLookups;
+    return 1;
+#else
+    (void)media;
+    memset(stats, 0, sizeof(TMediaStats));
+    return RANGE_ERROR;
+#endif
+}
+
+size_t mediaReservedBytes(const mediaADT media)
+{
+    return media->arena == NULL ? 0 : arenaReserved(media->arena);
+}
+
+size_t mediaUsedBytes(const mediaADT media)
+{
+    return media->arena == NULL ? 0 : arenaUsed(media->arena);
+}
+
+void freeMediaADT(mediaADT media){
+    /// Años, generos y contenidos viven en el arena, por lo que basta con liberar las tablas de punteros y el arena.
+    if (media->current != NULL)
+        freeVersion(media->current);
+    while (media->retired != NULL){
+        mediaADT aux = media->retired;
+        media->retired = aux->nextRetired;
+        freeVersion(aux);
     }
+    for (size_t i = 0; i < media->size; i++)
+        if (media->years[i] != NULL)
+            releaseFrozen(media->years[i]->frozen);
     free(media->years);
+    free(media->occupied);
+    free(media->contentChunks);
+    free(media->sharedChunks);
+    free(media->dict.names);
+    free(media->dict.table);
+    free(media->dict.order);
+    if (!isMapped(media, media->keyTable))
+        free(media->keyTable);
+    free(media->titleTable);
+    free(media->titleOrder);
+    free(media->rangeTrees);
+    if (media->ownsArena)
+        freeArenaADT(media->arena);
+    if (media->mapping != NULL)
+        munmap(media->mapping, media->mappingSize);
     free(media);
 }
@@ -2,6 +2,8 @@
 #define TPEFINAL_MEDIAADT_H
 
 #include <stdlib.h>
+#include "arenaADT.h"
+#include "columnKernels.h"
 
 /**
  * @brief Codigos de identificacion para los tipos de contenido.
@@ -11,6 +13,25 @@ typedef enum {
     CONTENTTYPE_SERIES       /**< @enum Identificador contenido tipo Serie    */
 } contentType;
 
+/**
+ * @brief Campos numericos de una pelicula/serie sobre los que se pueden calcular agregados.
+ */
+typedef enum {
+    FIELD_NUMVOTES = 0,      /**< @enum Cantidad de votos  */
+    FIELD_RATING,            /**< @enum Puntaje promedio   */
+    FIELD_RUNTIME,           /**< @enum Duracion en minutos */
+    FIELD_STARTYEAR,         /**< @enum Año de comienzo    */
+    FIELD_ENDYEAR            /**< @enum Año de finalizacion */
+} contentField;
+
+/**
+ * @brief Modos de funcionamiento del TAD, elegidos al crearlo.
+ */
+typedef enum {
+    MEDIA_FULL = 0,          /**< @enum Guarda cada pelicula/serie: admite todas las consultas                   */
+    MEDIA_AGGREGATE          /**< @enum Guarda solo las cantidades y la mas votada de cada año (memoria acotada) */
+} mediaMode;
+
 /**
  * @brief Códigos para manejo de errores.
  */
@@ -18,7 +39,8 @@ enum errorStates {
     CONTENTTYPE_ERROR = 200, /**< @enum Tipo de contenido invalido            */
     MEM_ERROR,               /**< @enum Error en asignacion de memoria        */
     INVALIDYEAR_ERROR,       /**< @enum Año inexistente o fuera de rango      */
-    RANGE_ERROR              /**< @enum El iterador no puede avanzar          */
+    RANGE_ERROR,             /**< @enum El iterador no puede avanzar          */
+    SNAPSHOT_ERROR           /**< @enum No se pudo escribir el snapshot       */
 };
 
 typedef struct mediaCDT * mediaADT;
@@ -35,6 +57,9 @@ typedef struct mediaCDT * mediaADT;
 #define MAX_TITLE_SIZE 256    /**< @def Tamaño maximo de titulo del contenido */
 #define MAX_TYPE_SIZE 32      /**< @def Tamaño maximo de tipo del contenido   */
 #define MAX_GENRE_SIZE 64     /**< @def Tamaño maximo de genero del contenido */
+#define MAX_GENRES 15         /**< @def Maxima cantidad de generos que aceptara el TAD por pelicula/serie */
+#define DEFAULT_TOP_K 10      /**< @def Cantidad de mas votadas que guarda el TAD por año y por genero     */
+#define MAX_TOP_K 100         /**< @def Maxima cantidad de mas votadas que se puede pedir con setTopK()    */
 
 /**
  * @brief El usuario debera definir una estructura con información sobre los contenidos
@@ -51,13 +76,107 @@ typedef struct content{
     float averageRating;                  /**< Numero decimal entre 0 y 10                     */
 } TContent;
 
+/**
+ * @brief Porcion de texto de entrada, indicada por puntero y longitud. No necesita terminar en '\0', lo que permite
+ * referenciar campos directamente dentro del buffer leido (por ejemplo, un archivo mapeado en memoria).
+ */
+typedef struct slice {
+    const char * str;                     /**< Comienzo del texto                              */
+    size_t len;                           /**< Cantidad de caracteres                          */
+} TSlice;
+
+/**
+ * @brief Fila de entrada ya separada en campos, cuyos textos apuntan al buffer de origen sin copiarse.
+ * El TAD copia unicamente lo que conserva (el titulo); los generos se traducen a identificadores.
+ */
+typedef struct rawContent {
+    TSlice primaryTitle;                  /**< Titulo Original                                 */
+    TSlice genres[MAX_GENRES];            /**< Generos del contenido ("\\N" si no tiene)        */
+    size_t genresCount;                   /**< Cantidad de generos en "genres"                 */
+    unsigned short startYear;             /**< El año de lanzamiento o comienzo de emisión     */
+    unsigned short endYear;               /**< Si es una serie, el año de finalizacion         */
+    unsigned short runtimeMinutes;        /**< Duracion en minutos                             */
+    unsigned long numVotes;               /**< Cantidad de votos que obtuvo                    */
+    float averageRating;                  /**< Numero decimal entre 0 y 10                     */
+    contentType type;                     /**< Tipo de contenido (pelicula o serie)            */
+} TRawContent;
+
+/**
+ * @brief Posicion de un recorrido por años. @see toBeginYearCursor()
+ * Sus campos son de uso interno del TAD.
+ */
+typedef struct yearCursor {
+    size_t index;                         /**< Posicion del proximo año                        */
+} TYearCursor;
+
+/**
+ * @brief Posicion de un recorrido por los generos de un año. @see toBeginGenreCursor()
+ * Sus campos son de uso interno del TAD.
+ */
+typedef struct genreCursor {
+    const struct year * year;             /**< Año recorrido                                   */
+    size_t position;                      /**< Posicion en el orden alfabetico de generos      */
+} TGenreCursor;
+
+/**
+ * @brief Posicion de un recorrido por las peliculas/series mas votadas. @see toBeginTopCursor()
+ * Sus campos son de uso interno del TAD.
+ */
+typedef struct topCursor {
+    unsigned int ids[MAX_TOP_K];          /**< Contenidos a recorrer, de mayor a menor         */
+    size_t count;                         /**< Cantidad de contenidos en "ids"                 */
+    size_t position;                      /**< Posicion del proximo contenido                  */
+} TTopCursor;
+
 /**
  * @brief Funcion que crea un nuevo mediaADT para el manejo de peliculas/series.
  *
- * @param minYear Menor año de estreno para peliculas/series.
+ * @details Toda la memoria de años, generos y contenidos se toma de un arena (@see arenaADT.h). El usuario puede
+ * pasar un arena propio, dimensionado segun el dataset, en cuyo caso debera liberarlo luego de freeMediaADT().
+ *
+ * En modo MEDIA_AGGREGATE el TAD no guarda las peliculas/series: por año y genero mantiene solo las cantidades, y
+ * por año una copia de la pelicula y de la serie mas votadas, que se sobrescribe cuando aparece una con mas votos.
+ * La memoria es proporcional a años x generos, sin importar la cantidad de filas. Admite las cantidades (tambien
+ * por rango de años), mostVoted() y los recorridos por años y generos; las mas votadas por genero, los cuantiles,
+ * countContentIf() y la busqueda por titulo no encuentran contenidos, y updateContent(), aggregateContent(),
+ * indexTitles() y publishMediaADT() devuelven RANGE_ERROR.
+ *
+ * La tabla de años no depende de minYear: comienza en el primer año añadido y crece hacia ambos extremos, duplicando
+ * su capacidad, por lo que los años pueden llegar en cualquier orden.
+ *
+ * @param minYear Menor año de estreno para peliculas/series (0 para aceptar cualquier año).
+ * @param arena Arena del cual se tomara la memoria. Si es NULL, el TAD crea y libera uno propio.
+ * @param mode MEDIA_FULL o MEDIA_AGGREGATE.
  * @return MediaADT creado.
+ * @return NULL si se produjo un error de memoria.
+ */
+mediaADT newMediaADT(const size_t minYear, arenaADT arena, const mediaMode mode);
+
+/**
+ * @brief Funcion que devuelve el modo con el que se creo el TAD.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
  */
-mediaADT newMediaADT(const size_t minYear);
+mediaMode getMediaMode(const mediaADT media);
+
+/**
+ * @brief Funcion que indica cuantas peliculas/series mas votadas guardara el TAD por año y por genero.
+ *
+ * @details Solo puede modificarse antes de añadir contenido. @see toBeginTop()
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param k Cantidad de mas votadas, entre 1 y MAX_TOP_K.
+ * @return 1 si se modifico exitosamente.
+ * @return RANGE_ERROR si k esta fuera de rango o el TAD ya tiene contenido.
+ */
+int setTopK(mediaADT media, const size_t k);
+
+/**
+ * @brief Funcion que devuelve cuantas peliculas/series mas votadas guarda el TAD por año y por genero.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ */
+size_t getTopK(const mediaADT media);
 
 /**
  * @brief Función que añade pelicula/serie a un media ADT.
@@ -65,6 +184,8 @@ mediaADT newMediaADT(const size_t minYear);
  * @details La lista de generos ingresados sera ordenada alfabeticamente en cada año, mientras que las peliculas
  * y series dentro de los generos no tendran ningun orden (seran metidas al final de los vectores a medida que se
  * ingresan)
+ * El contenido se copia una unica vez dentro del TAD; los generos y el año guardan solo una referencia al mismo. El
+ * vector "genre" no se conserva, por lo que el usuario puede liberarlo luego de la llamada.
  *
  * @param media ADT creado para el manejo de películas/series.
  * @param content Contenido que sera añadido al ADT.
@@ -79,6 +200,77 @@ mediaADT newMediaADT(const size_t minYear);
  */
 int addContent( mediaADT media , const TContent content ,const unsigned short year , char ** genre , const unsigned long numVotes , const contentType title);
 
+/**
+ * @brief Función que añade una fila de entrada ya separada en campos a un mediaADT.
+ *
+ * @details Equivalente a addContent(), pero sin exigir que los textos esten copiados en un TContent: el titulo y los
+ * generos se leen directamente del buffer de origen y solo se copia el titulo. Un genero "\\N" se registra como
+ * "Género no identificado".
+ *
+ * @param media ADT creado para el manejo de películas/series.
+ * @param content Fila a añadir. El año utilizado es content->startYear.
+ * @return 1 si "content" se añadio exitosamente.
+ * @return MEM_ERROR si se produjo un error de memoria.
+ * @return INVALIDYEAR_ERROR si el año es menor al año mínimo que acepta el TAD.
+ * @return CONTENTTYPE_ERROR si content->type no corresponde ni a una serie ni a una pelicula.
+ */
+int addRawContent( mediaADT media , const TRawContent * content );
+
+/**
+ * @brief Función que añade un lote de filas de entrada ya separadas en campos a un mediaADT.
+ *
+ * @details El resultado es el mismo que llamar a addRawContent() con cada fila en orden, pero las filas se agrupan
+ * por año antes de reservar nada: cada año distinto se resuelve una unica vez, cada forma de escribir un genero se
+ * busca en el diccionario una unica vez por lote, el almacen central se agranda una unica vez para todo el lote y los
+ * bloques de indices de cada genero se reservan una vez por grupo. Las cantidades por rango de años se registran con
+ * un unico cambio por año, genero y tipo. Pensada para cargadores que leen miles de filas por vez.
+ *
+ * @param media ADT creado para el manejo de películas/series.
+ * @param rows Filas a añadir. @see addRawContent
+ * @param n Cantidad de filas.
+ * @param status Vector de "n" posiciones donde se guarda el resultado de cada fila, con los mismos valores que
+ * devuelve addRawContent().
+ * @return 1 si no se produjeron errores de memoria.
+ * @return MEM_ERROR si se produjo un error de memoria. En ese caso las filas validas tambien quedan con MEM_ERROR.
+ */
+int addContentBatch(mediaADT media, const TRawContent * rows, const size_t n, int * status);
+
+/**
+ * @brief Funcion que añade una pelicula/serie o, si ya fue añadida, la corrige con los datos recibidos.
+ *
+ * @details Pensada para aplicar archivos de novedades sobre un TAD ya cargado. Dos filas corresponden a la misma
+ * pelicula/serie si coinciden su titulo, su año de comienzo y su tipo; la fila corregida reemplaza votos, puntaje,
+ * año de finalizacion, duracion y generos, y se actualizan las cantidades por genero y la mas votada del año. El
+ * costo es proporcional a la cantidad de filas aplicadas: el indice de claves se arma la primera vez que se llama a
+ * esta funcion y luego solo registra los contenidos nuevos.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param content Pelicula/serie a añadir o corregir. @see addRawContent
+ * @return 1 si se añadio o corrigio exitosamente.
+ * @return MEM_ERROR si se produjo un error de memoria.
+ * @return INVALIDYEAR_ERROR si el año es menor al año mínimo que acepta el TAD.
+ * @return CONTENTTYPE_ERROR si content->type no corresponde ni a una serie ni a una pelicula.
+ * @return RANGE_ERROR si el TAD esta en modo MEDIA_AGGREGATE.
+ */
+int updateContent( mediaADT media , const TRawContent * content );
+
+/**
+ * @brief Funcion que combina en un mediaADT todo el contenido de otro.
+ *
+ * @details Se suman las cantidades por año y genero, se combinan los generos de cada año y se elige la pelicula/serie
+ * mas votada de cada año entre ambos TADs. Ante igual cantidad de votos se conserva la de "media", por lo que si
+ * "other" se cargo con filas posteriores a las de "media" el resultado es igual a haber cargado todas las filas en
+ * orden sobre un unico TAD. "other" no se modifica y el usuario debera liberarlo.
+ *
+ * @param media ADT destino.
+ * @param other ADT cuyo contenido se agregara a "media".
+ * @return 1 si se combino exitosamente.
+ * @return MEM_ERROR si se produjo un error de memoria.
+ * @return INVALIDYEAR_ERROR si ambos TADs no tienen el mismo año minimo.
+ * @return RANGE_ERROR si ambos TADs no tienen el mismo modo.
+ */
+int mergeMediaADT(mediaADT media, const mediaADT other);
+
 /**
  * @brief Funcion para obtener la cantidad de peliculas/series para un año.
  *
@@ -102,6 +294,80 @@ size_t countContentByYear(const mediaADT media, const unsigned short year, conte
  */
 size_t countContentByGenre(const mediaADT media, const unsigned short year, const char * genre, contentType CONTENTTYPE_ );
 
+/**
+ * @brief Par de generos que aparecen juntos en peliculas/series de un año. @see topGenrePairs()
+ */
+typedef struct genrePair {
+    const char * genre;                   /**< Primer genero en orden alfabetico (valido mientras exista el TAD) */
+    const char * pairedGenre;             /**< Segundo genero en orden alfabetico                               */
+    size_t count;                         /**< Cantidad de peliculas/series con ambos generos                   */
+} TGenrePair;
+
+/**
+ * @brief Funcion para obtener la cantidad de peliculas/series de un año que tienen dos generos a la vez.
+ *
+ * @details Por año y tipo de contenido, el TAD mantiene una matriz de co-ocurrencias indexada por genero, que se
+ * actualiza al añadir, combinar o corregir contenido con un costo de O(k²) para una pelicula/serie con k generos.
+ * La consulta cuesta O(1) luego de resolver los generos. Se mantiene tambien en modo MEDIA_AGGREGATE.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año a consultar.
+ * @param genre Primer genero (sin distinguir mayusculas).
+ * @param pairedGenre Segundo genero (sin distinguir mayusculas). Si es el mismo que "genre", se devuelve lo mismo que
+ * countContentByGenre().
+ * @param CONTENTTYPE_ Tipo de contenido a contar.
+ * @return Cantidad de peliculas/series con ambos generos (0 si el año o algun genero son invalidos).
+ */
+size_t countContentByGenrePair(const mediaADT media, const unsigned short year, const char * genre,
+                               const char * pairedGenre, contentType CONTENTTYPE_);
+
+/**
+ * @brief Funcion que obtiene los pares de generos que aparecen juntos en mas peliculas/series de un año.
+ *
+ * @details Recorre la matriz de co-ocurrencias del año, por lo que cuesta O(g² * max) para g generos.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año a consultar.
+ * @param type Tipo de contenido a contar.
+ * @param pairs Vector donde se guardan los pares, de mayor a menor cantidad (ante igual cantidad, en orden
+ * alfabetico). Solo se incluyen pares con al menos una pelicula/serie.
+ * @param max Cantidad maxima de pares a guardar.
+ * @return Cantidad de pares guardados (0 si el año o type son invalidos).
+ */
+size_t topGenrePairs(const mediaADT media, const unsigned short year, const contentType type, TGenrePair * pairs,
+                     const size_t max);
+
+/**
+ * @brief Funcion para obtener la cantidad de peliculas/series de un rango de años.
+ *
+ * @details Las cantidades por año se mantienen en arboles de Fenwick que se actualizan al añadir, combinar o
+ * corregir contenido, por lo que la consulta cuesta O(log(cantidad de años)) sin importar el largo del rango.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param from Primer año del rango (incluido).
+ * @param to Ultimo año del rango (incluido).
+ * @param type Tipo de contenido a contar.
+ * @return Cantidad de peliculas/series del rango (0 si el rango esta vacio o type es invalido).
+ */
+size_t countContentByYearRange(const mediaADT media, const unsigned short from, const unsigned short to,
+                               const contentType type);
+
+/**
+ * @brief Funcion para obtener la cantidad de peliculas/series de un genero en un rango de años.
+ *
+ * @details Al igual que countContentByYearRange(), cuesta O(log(cantidad de años)).
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param from Primer año del rango (incluido).
+ * @param to Ultimo año del rango (incluido).
+ * @param genre Genero a contar (sin distinguir mayusculas).
+ * @param type Tipo de contenido a contar.
+ * @return Cantidad de peliculas/series del genero en el rango (0 si el genero no existe, el rango esta vacio o type
+ * es invalido).
+ */
+size_t countContentByGenreRange(const mediaADT media, const unsigned short from, const unsigned short to,
+                                const char * genre, const contentType type);
+
 /**
  * @brief Funcion que devuelve la pelicula/serie con mayor cantidad de votos del año.
  *
@@ -113,6 +379,98 @@ size_t countContentByGenre(const mediaADT media, const unsigned short year, cons
  */
 TContent mostVoted(const mediaADT media, const unsigned short year, const contentType CONTENTTYPE_);
 
+/*******************************************************************************
+ *  @section Cursores
+ *  @brief Versiones reentrantes de los iteradores por año, por genero y por mas
+ *  votadas.
+ *
+ *  @details Cada cursor guarda su propia posicion y puede declararse en la pila,
+ *  por lo que puede haber varios recorridos en curso sobre un mismo TAD. Las
+ *  funciones de consulta (cursores, cantidades, mas votadas, agregados y
+ *  cuantiles) no modifican el TAD, por lo que pueden ejecutarse desde varios
+ *  hilos a la vez mientras ningun hilo añada, combine o corrija contenido. Los
+ *  iteradores de las secciones siguientes guardan su posicion dentro del TAD y
+ *  solo admiten un recorrido de cada tipo a la vez.
+ *
+ *  @see toBeginYear()
+ *  @see toBeginGenre()
+ *  @see toBeginTop()
+********************************************************************************/
+
+/**
+ * @brief Funcion que inicializa un cursor en el año más actual. @see toBeginYear()
+ *
+ * @param media ADT creado para el manejo de películas/series.
+ * @param cursor Cursor a inicializar.
+ */
+void toBeginYearCursor(const mediaADT media, TYearCursor * cursor);
+
+/**
+ * @brief Funcion que consulta si existe un año valido siguiente en un cursor. @see hasNextYear()
+ */
+int hasNextYearCursor(const mediaADT media, const TYearCursor * cursor);
+
+/**
+ * @brief Funcion que pasa al siguiente año en un cursor. @see nextYear()
+ *
+ * @return Año valido siguiente del cursor.
+ * @return RANGE_ERROR Si no hay un año valido siguiente en el cursor.
+ */
+unsigned short nextYearCursor(const mediaADT media, TYearCursor * cursor);
+
+/**
+ * @brief Funcion que inicializa un cursor en el primer genero (en orden alfabetico) de un año. @see toBeginGenre()
+ *
+ * @param media ADT creado para el manejo de películas/series.
+ * @param cursor Cursor a inicializar.
+ * @param year Año para el cual se desea iterar los generos validos de series y peliculas.
+ * @return INVALIDYEAR_ERROR Si el año pasado como argumento es invalido.
+ * @return 1 Si el cursor fue seteado correctamente.
+ */
+int toBeginGenreCursor(const mediaADT media, TGenreCursor * cursor, const unsigned short year);
+
+/**
+ * @brief Funcion que consulta si existe un género válido siguiente en un cursor. @see hasNextGenre()
+ */
+int hasNextGenreCursor(const mediaADT media, TGenreCursor * cursor);
+
+/**
+ * @brief Funcion que pasa al siguiente genero en un cursor. @see nextGenre()
+ *
+ * @return Genero valido siguiente del cursor.
+ * @return NULL Si no hay un genero valido en el cursor.
+ */
+char * nextGenreCursor(const mediaADT media, TGenreCursor * cursor);
+
+/**
+ * @brief Funcion que inicializa un cursor en la pelicula/serie mas votada del año o del genero indicado.
+ * @see toBeginTop()
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param cursor Cursor a inicializar.
+ * @param year Año para el cual se desean las mas votadas.
+ * @param genre Genero para el cual se desean las mas votadas (sin distinguir mayusculas), o NULL para todo el año.
+ * @param type Tipo de contenido que se desea recorrer.
+ * @return INVALIDYEAR_ERROR Si el año pasado como argumento es invalido.
+ * @return CONTENTTYPE_ERROR Si type no corresponde ni a una serie ni a una pelicula.
+ * @return 1 Si el cursor fue seteado correctamente (aunque no haya contenidos para recorrer).
+ */
+int toBeginTopCursor(const mediaADT media, TTopCursor * cursor, const unsigned short year, const char * genre,
+                     const contentType type);
+
+/**
+ * @brief Funcion que consulta si existe una pelicula/serie siguiente en un cursor de mas votadas.
+ */
+int hasNextTopCursor(const TTopCursor * cursor);
+
+/**
+ * @brief Funcion que pasa a la siguiente pelicula/serie mas votada en un cursor. @see nextTop()
+ *
+ * @return TContent con los datos correspondientes a la pelicula/serie.
+ * @return TContent vacío si no hay un contenido siguiente en el cursor.
+ */
+TContent nextTopCursor(const mediaADT media, TTopCursor * cursor);
+
 /*******************************************************************************
  *  @section Iteracion por año
  *  @brief Funciones de iteracion para que el usuario consulte años validos
@@ -207,8 +565,361 @@ int hasNextGenre ( const mediaADT media );
  */
 char * nextGenre ( const mediaADT media );
 
+/*******************************************************************************
+ *  @section Iteracion por mas votadas
+ *  @brief Funciones de iteracion para que el usuario consulte las peliculas o
+ *  series mas votadas de un año, o de un genero en un año, de mayor a menor
+ *  cantidad de votos.
+ *
+ *  @details Se recorren como maximo getTopK() contenidos, que el TAD mantiene
+ *  a medida que se añade, combina o corrige contenido, por lo que la consulta
+ *  no recorre el año. Ante igual cantidad de votos primero se recibe el que se
+ *  añadio antes. Los contenidos sin votos no se consideran (@see mostVoted()).
+ *  Si se desea comenzar la iteracion o no se puede avanzar en la misma,
+ *  el usuario debera volver a ejecutar la funcion toBeginTop().
+ *
+ *  @see toBeginTop()
+ *  @see hasNextTop()
+ *  @see nextTop()
+********************************************************************************/
+
+/**
+ * @brief Funcion que inicializa el iterador en la pelicula/serie mas votada del año o del genero indicado.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año para el cual se desean las mas votadas.
+ * @param genre Genero para el cual se desean las mas votadas (sin distinguir mayusculas), o NULL para todo el año.
+ * @param type Tipo de contenido que se desea recorrer.
+ * @return INVALIDYEAR_ERROR Si el año pasado como argumento es invalido.
+ * @return CONTENTTYPE_ERROR Si type no corresponde ni a una serie ni a una pelicula.
+ * @return 1 Si el iterador fue seteado correctamente (aunque no haya contenidos para recorrer).
+ */
+int toBeginTop(const mediaADT media, const unsigned short year, const char * genre, const contentType type);
+
+/**
+ * @brief Funcion que consulta si existe una pelicula/serie siguiente entre las mas votadas.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @return 1 si existe un contenido siguiente del iterador.
+ */
+int hasNextTop(const mediaADT media);
+
+/**
+ * @brief Funcion que pasa a la siguiente pelicula/serie mas votada en el iterador.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @return TContent con los datos correspondientes a la pelicula/serie.
+ * @return TContent vacío si no hay un contenido siguiente en el iterador.
+ */
+TContent nextTop(const mediaADT media);
+
+/*******************************************************************************
+ *  @section Titulos
+ *  @brief Funciones para buscar peliculas/series por titulo exacto o por
+ *  prefijo del titulo.
+ *
+ *  @details El indice se arma con indexTitles() a partir del almacen central,
+ *  por lo que puede armarse luego de la carga del .csv o de un snapshot sin
+ *  volver a procesar el archivo. Tiene una tabla de hash para los titulos
+ *  exactos y un vector de contenidos ordenado por titulo para los prefijos.
+ *  Las busquedas distinguen mayusculas y solo consideran los contenidos
+ *  registrados en la ultima llamada a indexTitles(). Las versiones publicadas
+ *  con publishMediaADT() no incluyen el indice.
+********************************************************************************/
+
+/**
+ * @brief Pelicula/serie encontrada por titulo.
+ */
+typedef struct titleMatch {
+    unsigned int handle;                  /**< Identificador del contenido dentro del TAD      */
+    const char * primaryTitle;            /**< Titulo (valido mientras exista el TAD)          */
+    unsigned short startYear;             /**< El año de lanzamiento o comienzo de emisión     */
+    contentType type;                     /**< Tipo de contenido                               */
+    unsigned long numVotes;               /**< Cantidad de votos que obtuvo                    */
+    float averageRating;                  /**< Numero decimal entre 0 y 10                     */
+} TTitleMatch;
+
+/**
+ * @brief Funcion que registra en el indice de titulos los contenidos añadidos desde la llamada anterior.
+ *
+ * @details Cuesta O(k log k + n) para k contenidos nuevos y n registrados. Solo debe invocarla el hilo que añade
+ * contenido.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @return 1 si el indice quedo actualizado.
+ * @return MEM_ERROR si se produjo un error de memoria (el indice queda como estaba).
+ * @return RANGE_ERROR si el TAD esta en modo MEDIA_AGGREGATE.
+ */
+int indexTitles(mediaADT media);
+
+/**
+ * @brief Funcion que busca las peliculas/series con un titulo exacto.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param title Titulo a buscar.
+ * @param matches Vector donde se guardan hasta "max" contenidos encontrados.
+ * @param max Cantidad de posiciones de "matches".
+ * @return Cantidad total de contenidos con ese titulo (puede ser mayor a max).
+ */
+size_t findTitle(const mediaADT media, const char * title, TTitleMatch * matches, const size_t max);
+
+/**
+ * @brief Funcion que busca las peliculas/series cuyo titulo comienza con un prefijo, en orden alfabetico.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param prefix Prefijo a buscar ("" para todos los contenidos).
+ * @param matches Vector donde se guardan los primeros "max" contenidos encontrados.
+ * @param max Cantidad de posiciones de "matches".
+ * @return Cantidad total de contenidos con ese prefijo (puede ser mayor a max).
+ */
+size_t findTitlePrefix(const mediaADT media, const char * prefix, TTitleMatch * matches, const size_t max);
+
+/*******************************************************************************
+ *  @section Snapshots
+ *  @brief Funciones para guardar un mediaADT ya cargado en un archivo binario y
+ *  volver a utilizarlo sin procesar nuevamente el .csv.
+ *
+ *  @details El snapshot tiene version y suma de verificacion, y depende de la
+ *  arquitectura en la que se genero (se rechaza en otra). Al cargarlo, el
+ *  archivo se mapea en memoria y las consultas leen directamente del mismo:
+ *  solo se arman las tablas de años y generos, sin recorrer los contenidos.
+********************************************************************************/
+
+/**
+ * @brief Funcion que guarda el contenido completo de un mediaADT en un snapshot.
+ *
+ * @details Incluye años, tablas de generos, cantidades, mas votadas, contenidos y titulos. El archivo se escribe
+ * primero con el sufijo ".tmp" y reemplaza al destino solo si se escribio por completo.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param filePath Archivo destino.
+ * @return 1 si se guardo exitosamente.
+ * @return SNAPSHOT_ERROR si no se pudo escribir el archivo.
+ * @return MEM_ERROR si se produjo un error de memoria.
+ */
+int saveMediaADT(const mediaADT media, const char * filePath);
+
+/**
+ * @brief Funcion que crea un mediaADT a partir de un snapshot generado con saveMediaADT().
+ *
+ * @details El snapshot se mapea en memoria de forma privada, por lo que el TAD obtenido admite todas las funciones
+ * de este contrato (incluso añadir contenido) sin modificar el archivo.
+ *
+ * @param filePath Archivo del snapshot.
+ * @param arena Arena del cual se tomara la memoria para lo que se añada luego. Si es NULL, el TAD crea uno propio.
+ * @return MediaADT creado.
+ * @return NULL si el archivo no existe, no es un snapshot valido (version, arquitectura o suma de verificacion
+ * incorrectas) o se produjo un error de memoria.
+ */
+mediaADT loadMediaADT(const char * filePath, arenaADT arena);
+
+/*******************************************************************************
+ *  @section Agregados
+ *  @brief Funciones que recorren un campo numerico de muchas peliculas/series.
+ *
+ *  @details Los contenidos se guardan por columnas, por lo que estas funciones
+ *  solo leen el campo pedido (y el tipo o año para filtrar), utilizando los
+ *  kernels vectoriales de columnKernels.h.
+********************************************************************************/
+
 /**
- * @brief Funcion que libera los recursos reservados por mediaADT.
+ * @brief Funcion que calcula cantidad, suma, minimo y maximo de un campo de las peliculas o series indicadas.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año de comienzo a considerar, o 0 para considerar todos los años.
+ * @param genre Genero a considerar (sin distinguir mayusculas), o NULL para considerar todos los generos.
+ * @param type Tipo de contenido a considerar.
+ * @param field Campo a agregar.
+ * @param out Resultado. Si no hay contenidos que cumplan el filtro, todos sus campos quedan en 0.
+ * @return 1 si se calculo exitosamente.
+ * @return CONTENTTYPE_ERROR si type no corresponde ni a una serie ni a una pelicula.
+ * @return RANGE_ERROR si el TAD esta en modo MEDIA_AGGREGATE.
+ */
+int aggregateContent(const mediaADT media, const unsigned short year, const char * genre, const contentType type,
+                     const contentField field, TAggregate * out);
+
+/**
+ * @brief Funcion que cuenta las peliculas o series indicadas cuyo campo se encuentra en el rango [min, max].
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año de comienzo a considerar, o 0 para considerar todos los años.
+ * @param genre Genero a considerar (sin distinguir mayusculas), o NULL para considerar todos los generos.
+ * @param type Tipo de contenido a considerar.
+ * @param field Campo a comparar.
+ * @param min Extremo inferior del rango (incluido).
+ * @param max Extremo superior del rango (incluido).
+ * @return Cantidad de contenidos en el rango (0 si type es invalido o el TAD esta en modo MEDIA_AGGREGATE).
+ */
+size_t countContentIf(const mediaADT media, const unsigned short year, const char * genre, const contentType type,
+                      const contentField field, const double min, const double max);
+
+/*******************************************************************************
+ *  @section Cuantiles
+ *  @brief Funciones que consultan cuantiles (por ejemplo, mediana o percentil 90)
+ *  del puntaje y la duracion de las peliculas o series de un año y genero.
+ *
+ *  @details Cada año y cada genero de un año mantienen, por tipo de contenido,
+ *  un sketch de tamaño fijo que se actualiza al añadir, combinar o corregir
+ *  contenido, por lo que la consulta no recorre los contenidos. El puntaje se
+ *  informa con un decimal (exacto para puntajes con un decimal) y la duracion
+ *  con error relativo menor a 1/32 a partir de 32 minutos. Se utiliza el
+ *  cuantil de rango mas cercano: el menor valor que alcanza a la fraccion "q"
+ *  de los contenidos.
+********************************************************************************/
+
+/**
+ * @brief Funcion que devuelve un cuantil del puntaje de las peliculas o series indicadas.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año de comienzo a considerar, o 0 para considerar todos los años.
+ * @param genre Genero a considerar (sin distinguir mayusculas), o NULL para considerar todos los generos.
+ * @param type Tipo de contenido a considerar.
+ * @param q Cuantil entre 0 y 1 (0.5 para la mediana).
+ * @return Puntaje correspondiente al cuantil.
+ * @return -1 si no hay contenidos que cumplan el filtro, type es invalido o q no esta entre 0 y 1.
+ */
+double ratingQuantile(const mediaADT media, const unsigned short year, const char * genre, const contentType type,
+                      const double q);
+
+/**
+ * @brief Funcion que devuelve un cuantil de la duracion en minutos de las peliculas o series indicadas.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param year Año de comienzo a considerar, o 0 para considerar todos los años.
+ * @param genre Genero a considerar (sin distinguir mayusculas), o NULL para considerar todos los generos.
+ * @param type Tipo de contenido a considerar.
+ * @param q Cuantil entre 0 y 1 (0.5 para la mediana).
+ * @return Duracion correspondiente al cuantil.
+ * @return -1 si no hay contenidos que cumplan el filtro, type es invalido o q no esta entre 0 y 1.
+ */
+double runtimeQuantile(const mediaADT media, const unsigned short year, const char * genre, const contentType type,
+                       const double q);
+
+/*******************************************************************************
+ *  @section Estadisticas
+ *  @brief Contadores internos del TAD para diagnosticar cargas lentas.
+ *
+ *  @details El TAD cuenta las filas añadidas, corregidas y rechazadas, las
+ *  reservas del arena, el crecimiento de sus tablas, las busquedas en el
+ *  diccionario de generos (con la cantidad de posiciones visitadas) y el tiempo
+ *  de cada fase. Los contadores de un TAD combinado con mergeMediaADT() se
+ *  suman a los del destino. Compilando con -DMEDIA_NO_STATS se eliminan los
+ *  contadores y getMediaStats() informa que no estan disponibles.
+********************************************************************************/
+
+/**
+ * @brief Estadisticas acumuladas por el TAD desde su creacion. Los tiempos se miden en nanosegundos.
+ */
+typedef struct mediaStats {
+    size_t rowsAdded;               /**< Filas añadidas con addContent(), addRawContent() o updateContent()    */
+    size_t rowsCorrected;           /**< Filas que corrigieron un contenido existente con updateContent()      */
+    size_t rowsRejected;            /**< Filas rechazadas con CONTENTTYPE_ERROR                                */
+    size_t rowsInvalidYear;         /**< Filas rechazadas con INVALIDYEAR_ERROR                                */
+    size_t contentsMerged;          /**< Contenidos incorporados desde otros TAD con mergeMediaADT()           */
+    size_t arenaAllocs;             /**< Reservas tomadas del arena (incluidas las de los TAD combinados)      */
+    size_t arenaBytes;              /**< Bytes tomados del arena (incluidos los de los TAD combinados)         */
+    size_t tableGrowths;            /**< Veces que se agrando una tabla con realloc o calloc                   */
+    size_t tableGrowthBytes;        /**< Bytes de las tablas agrandadas, luego de agrandarlas                  */
+    size_t genreLookups;            /**< Generos buscados en el diccionario al añadir o combinar contenido     */
+    size_t genreProbes;             /**< Posiciones de la tabla de hash visitadas en esas busquedas           */
+    double meanGenreProbes;         /**< Promedio de posiciones visitadas por busqueda (0 si no hubo)         */
+    unsigned long long insertNs;    /**< Tiempo añadiendo filas (estimado a partir de una muestra de las filas) */
+    unsigned long long correctNs;   /**< Tiempo corrigiendo filas con updateContent()                          */
+    unsigned long long mergeNs;     /**< Tiempo combinando otros TAD con mergeMediaADT()                       */
+    unsigned long long saveNs;      /**< Tiempo guardando snapshots con saveMediaADT()                         */
+    unsigned long long loadNs;      /**< Tiempo cargando el snapshot con loadMediaADT()                        */
+} TMediaStats;
+
+/**
+ * @brief Funcion que devuelve las estadisticas acumuladas por el TAD.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param stats Estadisticas a completar. Si el TAD se compilo sin estadisticas queda en cero.
+ * @return 1 si se completaron las estadisticas.
+ * @return RANGE_ERROR si el TAD se compilo con -DMEDIA_NO_STATS.
+ */
+int getMediaStats(const mediaADT media, TMediaStats * stats);
+
+/*******************************************************************************
+ *  @section Versiones
+ *  @brief Funciones para consultar el TAD desde otros hilos mientras un unico
+ *  hilo escritor sigue añadiendo contenido.
+ *
+ *  @details El escritor publica periodicamente una version inmutable del TAD
+ *  con publishMediaADT(). Cada lector fija la ultima version publicada con
+ *  pinMediaADT(), la consulta sin bloqueos y la libera con unpinMediaADT(). Al
+ *  publicar solo se copian los años modificados desde la publicacion anterior
+ *  (sus tablas de generos, mas votadas y cuantiles); los contenidos y los
+ *  bloques de indices completos se comparten. Las versiones reemplazadas se
+ *  liberan en una publicacion posterior, cuando ningun lector que pudiera
+ *  tenerlas fijadas sigue activo.
+ *
+ *  Las versiones admiten las funciones de consulta (cursores, cantidades, mas
+ *  votadas, agregados y cuantiles), pero no deben modificarse, guardarse ni
+ *  liberarse, y los iteradores que guardan su posicion en el TAD no deben
+ *  compartirse entre hilos. Añadir, combinar y corregir contenido queda
+ *  aislado de las versiones publicadas: la primera correccion de un contenido
+ *  luego de publicar (updateContent()) copia su bloque de contenidos y los
+ *  bloques de indices compartidos que modifica, y las versiones conservan los
+ *  originales.
+********************************************************************************/
+
+/**
+ * @brief Version fijada por un lector.
+ */
+typedef struct mediaPin {
+    mediaADT version;           /**< Version inmutable del TAD que puede consultarse */
+    size_t slot;                /**< Posicion del lector dentro del TAD              */
+} TMediaPin;
+
+/**
+ * @brief Funcion que publica el estado actual del TAD como una version inmutable para los lectores.
+ *
+ * @details Solo debe invocarla el hilo que añade contenido.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @return 1 si se publico exitosamente.
+ * @return MEM_ERROR si se produjo un error de memoria (la version anterior sigue publicada).
+ * @return RANGE_ERROR si el TAD esta en modo MEDIA_AGGREGATE.
+ */
+int publishMediaADT(mediaADT media);
+
+/**
+ * @brief Funcion que fija la ultima version publicada del TAD para consultarla.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param pin Version fijada. Debe liberarse con unpinMediaADT().
+ * @return 1 si se fijo exitosamente.
+ * @return RANGE_ERROR si todavia no se publico ninguna version o hay demasiados lectores con una version fijada.
+ */
+int pinMediaADT(mediaADT media, TMediaPin * pin);
+
+/**
+ * @brief Funcion que libera una version fijada con pinMediaADT().
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param pin Version a liberar. Luego de la llamada, pin->version no debe utilizarse.
+ */
+void unpinMediaADT(mediaADT media, TMediaPin * pin);
+
+/**
+ * @brief Funcion que devuelve la cantidad de bytes reservados por el arena del TAD.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ */
+size_t mediaReservedBytes(const mediaADT media);
+
+/**
+ * @brief Funcion que devuelve la cantidad de bytes efectivamente utilizados del arena del TAD.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ */
+size_t mediaUsedBytes(const mediaADT media);
+
+/**
+ * @brief Funcion que libera los recursos reservados por mediaADT, incluidas las versiones publicadas.
+ *
+ * @details No debe haber versiones fijadas por lectores.
  *
  * @param media ADT creado para el manejo de peliculas/series.
  */
@@ -1,14 +1,34 @@
+#define _POSIX_C_SOURCE 200112L
 #include "mediaADT.h"
+#include "rowParser.h"
+#include "ringBuffer.h"
+#include "csvWriter.h"
+#include "inputStream.h"
 #include <stdio.h>
 #include <string.h>
 #include <strings.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <pthread.h>
 
 
 #define MIN_YEAR 1850         /**< @def Minimo año que aceptara el TAD de pelicula/serie                     */
-#define MAX_GENRES 15         /**< @def Maxima cantidad de generos que aceptara el TAD por pelicula/serie    */
 #define BUFFER_SIZE 512       /**< @def  Maxima cantidad de caracteres por linea que se obtendra del archivo */
 
+
+#define MAX_THREADS 64        /**< @def  Maxima cantidad de hilos de carga                                   */
+#define MAX_DELTAS 32         /**< @def  Maxima cantidad de archivos de novedades                            */
+#define READ_BLOCK (1 << 20)  /**< @def  Tamaño de los bloques que lee la primera etapa del pipeline           */
+#define RING_CAPACITY 8       /**< @def  Capacidad de las colas entre etapas del pipeline                     */
+#define BATCH_BLOCK 1024      /**< @def  Bloque de crecimiento de las filas de un lote                         */
+#define MAX_SINKS 8           /**< @def  Maxima cantidad de consultas que se resuelven en un mismo recorrido   */
+
 #define INVALID_PATH (-1)     /**< @def  Codigo definido para indicar error de un Path que es invalido       */
+#define INVALID_ARGS (-2)     /**< @def  Codigo definido para indicar error en los argumentos del programa   */
+#define INVALID_INPUT (-3)    /**< @def  Codigo definido para indicar un archivo comprimido no soportado o dañado */
 
 /** Macro que determina si S1 es del tipo pasado como parametro TYPE */
 #define COMPARE_TYPES(S1,S2,TYPE) { if (strcasecmp((S1),(S2))==0) \
@@ -20,13 +40,242 @@
                                                   errorManager((ERROR_TYPE),(ADT));}
 
 /** Macro que determina si E es un error FATAL que debe abortar la ejecucion del programa
- * , esto es , RANGE_ERROR , MEM_ERROR o INVALID_PATH  
+ * , esto es , RANGE_ERROR , MEM_ERROR , INVALID_PATH , INVALID_ARGS o INVALID_INPUT
  */
-#define IS_FATALERROR(E) ( (E) == RANGE_ERROR || (E) == MEM_ERROR || (E) == INVALID_PATH )
+#define IS_FATALERROR(E) ( (E) == RANGE_ERROR || (E) == MEM_ERROR || (E) == INVALID_PATH || (E) == INVALID_ARGS || \
+                           (E) == INVALID_INPUT )
+
+#ifndef MEDIA_NO_STATS
+/** Macro que cuenta un evento para --stats. Los contadores se comparten entre los hilos de carga */
+#define STATS_COUNT(C) __atomic_fetch_add(&(C), 1, __ATOMIC_RELAXED)
+#else
+#define STATS_COUNT(C) ((void)0)
+#endif
 
 const char * UNDEFINED_SYMBOL = "\\N"; /**< String que se colocara en campos vacios durante la impresion */
 
-int getDataFromFile(mediaADT media, const char * filePath);
+/**
+ * @brief Modos de lectura del archivo de entrada.
+ */
+typedef enum {
+    LOADER_STDIO = 0,   /**< @enum Lectura por lineas con fgets (modo por defecto)          */
+    LOADER_MMAP,        /**< @enum Archivo mapeado en memoria, campos leidos sin copiarse  */
+    LOADER_PIPELINE     /**< @enum Lectura, separacion e insercion en tres hilos en cadena */
+} loaderMode;
+
+/**
+ * @brief Opciones de ejecucion obtenidas de la linea de comandos.
+ */
+typedef struct options {
+    const char * filePath;    /**< Archivo .csv de entrada                                            */
+    loaderMode loader;        /**< Modo de lectura del archivo                                        */
+    int advice;               /**< Sugerencia de acceso para posix_madvise (modo LOADER_MMAP)          */
+    size_t readahead;         /**< Bytes a pedir por adelantado con POSIX_MADV_WILLNEED (0: no se pide) */
+    int throughput;           /**< 1 si se debe informar la velocidad de carga por salida de error      */
+    size_t threads;           /**< Cantidad de hilos de carga (modo LOADER_MMAP)                        */
+    const char * snapshot;    /**< Snapshot a utilizar en lugar del .csv si esta actualizado (o NULL)    */
+    const char * deltas[MAX_DELTAS]; /**< Archivos de novedades a aplicar, en orden, luego de la carga   */
+    size_t deltasCount;       /**< Cantidad de archivos de novedades                                    */
+    size_t topK;              /**< Cantidad de mas votadas por año y genero a informar en query4        */
+    int stats;                /**< 1 si se deben informar las estadisticas en JSON por salida de error  */
+    mediaMode mode;           /**< MEDIA_AGGREGATE si solo se deben mantener las cantidades (--aggregate) */
+    int pairs;                /**< 1 si se debe informar query5 con los pares de generos (--pairs)      */
+} TOptions;
+
+/**
+ * @brief Fases de la ejecucion que se miden para --stats.
+ */
+typedef enum {
+    PHASE_LOAD = 0,     /**< @enum Carga del .csv o del snapshot                    */
+    PHASE_SAVE,         /**< @enum Escritura del snapshot                           */
+    PHASE_DELTAS,       /**< @enum Aplicacion de los archivos de novedades          */
+    PHASE_QUERIES,      /**< @enum Resolucion y escritura de las consultas          */
+    PHASE_FREE,         /**< @enum Liberacion del TAD                               */
+    PHASES_COUNT
+} phaseId;
+
+/**
+ * @brief Estadisticas de la ejecucion que se informan con --stats.
+ */
+typedef struct runStats {
+    double phases[PHASES_COUNT];  /**< Segundos de cada fase                                       */
+    size_t rejectedType;          /**< Filas rechazadas por CONTENTTYPE_ERROR                      */
+    size_t rejectedYear;          /**< Filas rechazadas por INVALIDYEAR_ERROR                      */
+} TRunStats;
+
+static TRunStats runStats;        /**< Estadisticas de la ejecucion actual                         */
+
+/**
+ * @brief Porcion del archivo mapeado que carga un hilo en su propio mediaADT.
+ */
+typedef struct shard {
+    pthread_t thread;         /**< Hilo que carga la porcion                          */
+    mediaADT media;           /**< ADT propio del hilo                                */
+    const char * data;        /**< Comienzo de la porcion (siempre en comienzo de linea) */
+    size_t len;               /**< Longitud de la porcion (siempre termina en fin de linea) */
+    size_t rows;              /**< Cantidad de filas leidas por el hilo               */
+} TShard;
+
+/**
+ * @brief Bloque de lineas completas leido por la primera etapa del pipeline.
+ */
+typedef struct block {
+    char * data;              /**< Lineas leidas (el bloque es dueño de la memoria)   */
+    size_t len;               /**< Longitud del bloque                                */
+} TBlock;
+
+/**
+ * @brief Lote de filas separadas de un bloque de lineas, que se añade al TAD con addContentBatch(). Los textos de las
+ * filas apuntan a su bloque, por lo que el bloque se libera junto con el lote, luego de insertarlo.
+ */
+typedef struct batch {
+    TBlock * block;           /**< Bloque del cual se separaron las filas (en el pipeline) */
+    TRawContent * rows;       /**< Filas de tipo valido, en orden                     */
+    size_t rowsCount;         /**< Cantidad de filas de tipo valido                   */
+    int * status;             /**< Tipo de contenido de cada fila o CONTENTTYPE_ERROR  */
+    size_t count;             /**< Cantidad de filas del lote                         */
+} TBatch;
+
+/**
+ * @brief Estado compartido por las etapas del pipeline de carga.
+ */
+typedef struct pipeline {
+    streamADT stream;         /**< Archivo de entrada (descomprimido por la primera etapa) */
+    ringADT blocks;           /**< Cola lectura -> separacion                         */
+    ringADT batches;          /**< Cola separacion -> insercion                       */
+    int error;                /**< MEM_ERROR si alguna etapa no pudo reservar memoria */
+} TPipeline;
+
+/**
+ * @brief Funcion que interpreta los argumentos del programa.
+ *
+ * @details Uso: imdb [--mmap|--pipeline] [--madvise=normal|sequential|random|willneed] [--readahead=MB] [--threads=N]
+ * [--throughput] [--stats] [--aggregate] [--pairs] [--snapshot=archivo] [--delta=archivo ...] [--top=K]
+ * archivo.csv|-
+ *
+ * Con "-" se lee la entrada estandar. --aggregate no admite --delta, ya que no se guardan las filas a corregir.
+ *
+ * @param argc Cantidad de argumentos.
+ * @param argv Argumentos.
+ * @param options Opciones a completar.
+ * @return 1 si los argumentos son validos o INVALID_ARGS si no lo son.
+ */
+int parseArguments(int argc, char * argv[], TOptions * options);
+
+/**
+ * @brief Funcion que determina si un snapshot es posterior al archivo .csv del cual se genero.
+ *
+ * @param snapshot Archivo del snapshot.
+ * @param filePath Archivo .csv.
+ * @return 1 si el snapshot existe y no es anterior al .csv, 0 si no.
+ */
+int isSnapshotFresh(const char * snapshot, const char * filePath);
+
+/**
+ * @brief Funcion que carga el archivo leyendolo linea por linea.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param filePath Archivo .csv de entrada.
+ * @return Cantidad de filas leidas (sin contar el encabezado).
+ */
+size_t getDataFromFile(mediaADT media, const char * filePath);
+
+/**
+ * @brief Funcion que carga el archivo mapeandolo en memoria y separando cada linea en campos sin copiarlos.
+ *
+ * @details Las lineas pueden tener cualquier longitud. Los campos se separan con parseRows() y se envian al TAD
+ * como porciones del archivo mapeado (@see addRawContent), por lo que solo se copia lo que el TAD conserva.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param options Opciones de ejecucion (archivo y sugerencias de acceso a memoria).
+ * @return Cantidad de filas leidas (sin contar el encabezado).
+ */
+size_t getDataFromMappedFile(mediaADT media, const TOptions * options);
+
+/**
+ * @brief Funcion que aplica un archivo de novedades sobre el TAD ya cargado.
+ *
+ * @details El archivo tiene el mismo formato que el .csv de entrada. Cada fila añade una pelicula/serie nueva o
+ * corrige una ya cargada con el mismo titulo, año y tipo (@see updateContent), por lo que el costo depende solo del
+ * tamaño del archivo de novedades.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param filePath Archivo de novedades.
+ * @return Cantidad de filas leidas (sin contar el encabezado).
+ */
+size_t applyDeltaFile(mediaADT media, const char * filePath);
+
+/**
+ * @brief Funcion que separa las filas de un bloque de lineas completas y las añade al TAD, utilizando varios hilos.
+ *
+ * @details El bloque se divide en "threads" porciones cortadas en fin de linea. Cada hilo carga su porcion en un
+ * mediaADT propio y luego las porciones se combinan en orden mediante mergeMediaADT, por lo que el resultado es
+ * igual al de una carga secuencial.
+ *
+ * @param media ADT creado para el manejo de peliculas/series. Recibe directamente la primera porcion.
+ * @param data Comienzo del bloque.
+ * @param len Longitud del bloque.
+ * @param threads Cantidad de hilos.
+ * @return Cantidad de filas leidas.
+ */
+size_t parseRowsParallel(mediaADT media, const char * data, size_t len, size_t threads);
+
+/**
+ * @brief Funcion que ejecuta cada hilo de parseRowsParallel() sobre su TShard.
+ */
+void * loadShard(void * shard);
+
+/**
+ * @brief Funcion que carga el archivo con un pipeline de tres etapas: un hilo lee bloques de lineas completas, otro
+ * los separa en lotes de filas y el hilo actual inserta los lotes en el TAD.
+ *
+ * @details Las etapas se comunican mediante colas acotadas sin locks (@see ringBuffer.h); si una etapa es mas lenta,
+ * la anterior espera al llenarse la cola. Las lineas pueden tener cualquier longitud.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param options Opciones de ejecucion.
+ * @return Cantidad de filas leidas (sin contar el encabezado).
+ */
+size_t getDataFromPipeline(mediaADT media, const TOptions * options);
+
+/**
+ * @brief Primera etapa del pipeline: lee el archivo en bloques que terminan en fin de linea. @see TPipeline
+ */
+void * readStage(void * pipeline);
+
+/**
+ * @brief Segunda etapa del pipeline: separa cada bloque en un lote de filas. @see TPipeline
+ */
+void * parseStage(void * pipeline);
+
+/**
+ * @brief Funcion que añade un lote al TAD con addContentBatch() e informa el error de cada fila en el orden del
+ * archivo.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param batch Lote a insertar.
+ */
+void insertBatch(mediaADT media, const TBatch * batch);
+
+/**
+ * @brief Funcion que separa un bloque de lineas completas en lotes de a lo sumo READ_BLOCK bytes (cortados en fin de
+ * linea) y los añade al TAD. @see insertBatch
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param data Comienzo del bloque.
+ * @param len Longitud del bloque.
+ * @return Cantidad de filas leidas.
+ */
+size_t loadRows(mediaADT media, const char * data, size_t len);
+
+/**
+ * @brief Funcion que añade o corrige en el TAD una fila de un archivo de novedades. @see rowCallback
+ *
+ * @param context ADT creado para el manejo de peliculas/series.
+ * @param status Tipo de contenido de la fila o CONTENTTYPE_ERROR.
+ * @param row Fila separada en campos.
+ */
+void updateRow(void * context, int status, const TRawContent * row);
 
 /**
  * @brief Funcion que llena un vector de char * pasado como parametro con los generos especificados por parametro "string".
@@ -66,6 +315,23 @@ TContent createContent(char * line, const char * delim );
  */
 void errorManager ( int error , mediaADT media );
 
+/**
+ * @brief Funcion que suma a una fase el tiempo transcurrido desde "mark" y deja "mark" en el instante actual.
+ *
+ * @param phase Fase a la que se suma el tiempo.
+ * @param mark Comienzo de la fase.
+ */
+void endPhase(phaseId phase, struct timespec * mark);
+
+/**
+ * @brief Funcion que informa por salida de error, en JSON, las estadisticas de la ejecucion y del TAD.
+ *
+ * @param options Opciones de ejecucion.
+ * @param rows Cantidad de filas leidas.
+ * @param media Estadisticas del TAD, tomadas antes de liberarlo (NULL si se compilo sin estadisticas).
+ */
+void printStats(const TOptions * options, size_t rows, const TMediaStats * media);
+
 /**
  * @brief Funcion que determina si el contenido es una pelicula , serie u otro.
  *
@@ -80,48 +346,257 @@ void errorManager ( int error , mediaADT media );
 contentType getContentType ( TContent content );
 
 /**
- * @brief Funcion que consulta la cantidad de peliculas y series de cada año. Crea un archivo en el directorio especificado
- * y escribe el mismo con la informacion obtenida.
+ * @brief Consulta que produce un archivo de salida a partir de un unico recorrido por años y generos.
  *
- * @param media ADT creado para el manejo de peliculas/series.
- * @param filePath Directorio destino del archivo.
+ * @details Cada consulta indica el encabezado de su archivo y que escribir en cada año (antes de sus generos) y en
+ * cada genero de cada año. Cualquiera de las dos funciones puede ser NULL si la consulta no las necesita.
+ */
+typedef struct querySink {
+    const char * header;      /**< Encabezado del archivo                                        */
+    void (*onYear)(writerADT out, mediaADT media, unsigned short year);                      /**< Por año    */
+    void (*onGenre)(writerADT out, mediaADT media, unsigned short year, const char * genre); /**< Por genero */
+} TQuerySink;
+
+/**
+ * @brief Conjunto de consultas que se resuelven juntas recorriendo los años y generos una unica vez.
  */
-void query1(mediaADT media, char * filePath);
+typedef struct queryPlan {
+    const TQuerySink * sinks[MAX_SINKS]; /**< Consultas registradas                         */
+    writerADT files[MAX_SINKS];          /**< Archivo destino de cada consulta              */
+    size_t count;                        /**< Cantidad de consultas registradas             */
+} TQueryPlan;
 
+/**
+ * @brief Funcion que registra una consulta en un plan: crea el archivo destino y escribe su encabezado.
+ *
+ * @param plan Plan de consultas.
+ * @param sink Consulta a registrar.
+ * @param filePath Directorio destino del archivo.
+ * @return 1 si se registro correctamente.
+ * @return INVALID_PATH si no se pudo crear el archivo.
+ * @return RANGE_ERROR si el plan ya tiene MAX_SINKS consultas.
+ */
+int addQuery(TQueryPlan * plan, const TQuerySink * sink, const char * filePath);
 
 /**
- * @brief Funcion que consulta la cantidad de peliculas y series de cada año y genero. Crea un archivo en el directorio
- * especificado y escribe en el mismo con la iformacion obtenida.
+ * @brief Funcion que resuelve todas las consultas de un plan en un unico recorrido por años (y por generos de cada
+ * año, solo si alguna consulta lo necesita) y cierra sus archivos.
+ *
+ * @details El recorrido utiliza cursores propios, por lo que distintos planes pueden resolverse a la vez desde varios
+ * hilos sobre un mismo TAD ya cargado.
  *
  * @param media ADT creado para el manejo de peliculas/series.
- * @param filePath Directorio destino del archivo.
+ * @param plan Plan de consultas.
+ */
+void runQueryPlan(mediaADT media, TQueryPlan * plan);
+
+/**
+ * @brief Consulta de la cantidad de peliculas y series de cada año.
  */
-void query2(mediaADT media, char * filePath);
+extern const TQuerySink QUERY1;
 
 /**
- * @brief Funcion que consulta las peliculas y series más votadas de cada año. Crea un archivo en el directorio especificado
- * y escribe el mismo con la informacion obtenida.
+ * @brief Consulta de la cantidad de peliculas de cada año y genero.
+ */
+extern const TQuerySink QUERY2;
+
+/**
+ * @brief Consulta de las peliculas y series más votadas de cada año.
+ */
+extern const TQuerySink QUERY3;
+
+/**
+ * @brief Consulta de las peliculas y series más votadas de cada año, y de cada genero en cada año.
  *
- * @param media ADT creado para el manejo de películas/series.
+ * @details Para cada año se escriben primero las mas votadas del año (genero "\\N") y luego las de cada genero en
+ * orden alfabetico; en ambos casos primero las peliculas y luego las series, de mayor a menor cantidad de votos.
+ */
+extern const TQuerySink QUERY4;
+
+/**
+ * @brief Consulta de la cantidad de peliculas y series de cada año con cada par de generos.
+ *
+ * @details Para cada año y genero se escriben los generos posteriores en orden alfabetico que aparecen junto al
+ * mismo en al menos una pelicula/serie, por lo que cada par se escribe una unica vez.
+ */
+extern const TQuerySink QUERY5;
+
+/**
+ * @brief Funcion que resuelve una unica consulta. Crea un archivo en el directorio especificado y escribe en el mismo
+ * la informacion obtenida.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param sink Consulta a resolver.
  * @param filePath Directorio destino del archivo.
  */
-void query3(mediaADT media, char * filePath);
+void runQuery(mediaADT media, const TQuerySink * sink, const char * filePath);
 
 int main(int argc, char *argv[]) {
 
-    mediaADT media = newMediaADT(MIN_YEAR);
+    TOptions options;
+    ERROR_MANAGER(parseArguments(argc, argv, &options),INVALID_ARGS,NULL,INVALID_ARGS)
+
+    struct timespec start, end, mark;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    mark = start;
+    size_t rows = 0;
+
+    /// Si hay un snapshot actualizado se utiliza directamente; si no (o si no es valido) se carga el .csv.
+    mediaADT media = NULL;
+    if (options.snapshot != NULL && isSnapshotFresh(options.snapshot, options.filePath))
+        media = loadMediaADT(options.snapshot, NULL);
+    /// Un snapshot generado con otra cantidad de mas votadas, o en otro modo, no sirve para esta ejecucion.
+    if (media != NULL && (getTopK(media) != options.topK || getMediaMode(media) != options.mode)) {
+        freeMediaADT(media);
+        media = NULL;
+    }
+    endPhase(PHASE_LOAD, &mark);
+
+    if (media == NULL) {
+        media = newMediaADT(MIN_YEAR, NULL, options.mode);
+        ERROR_MANAGER(media,NULL,media,MEM_ERROR)
+        setTopK(media, options.topK);
 
-    getDataFromFile(media, argv[1]);
+        /// Un archivo comprimido solo puede leerse en orden, por lo que se descomprime en la primera etapa del
+        /// pipeline, en paralelo con la separacion y la insercion.
+        streamFormat format = detectStreamFormat(options.filePath);
+        ERROR_MANAGER(isStreamFormatSupported(format),0,media,INVALID_INPUT)
+        if (format != STREAM_PLAIN || strcmp(options.filePath, STDIN_PATH) == 0)
+            options.loader = LOADER_PIPELINE;
 
-    query1(media, "query1.csv");
-    query2(media, "query2.csv");
-    query3(media, "query3.csv");
+        if (options.loader == LOADER_MMAP)
+            rows = getDataFromMappedFile(media, &options);
+        else if (options.loader == LOADER_PIPELINE)
+            rows = getDataFromPipeline(media, &options);
+        else
+            rows = getDataFromFile(media, options.filePath);
+        endPhase(PHASE_LOAD, &mark);
+
+        if (options.snapshot != NULL)
+            ERROR_MANAGER(saveMediaADT(media, options.snapshot),SNAPSHOT_ERROR,media,SNAPSHOT_ERROR)
+        endPhase(PHASE_SAVE, &mark);
+    }
+
+    /// Las novedades se aplican sobre la carga base (el snapshot guardado corresponde solo al .csv).
+    for (size_t i = 0; i < options.deltasCount; i++)
+        rows += applyDeltaFile(media, options.deltas[i]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    endPhase(PHASE_DELTAS, &mark);
+
+    if (options.throughput) {
+        double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        fprintf(stderr, "filas: %lu\nsegundos: %.3f\nfilas/s: %.0f\n", (unsigned long)rows, seconds,
+                seconds > 0 ? rows / seconds : 0);
+    }
+
+    /// Todas las consultas se resuelven en un unico recorrido por años y generos.
+    TQueryPlan plan = { {NULL}, {NULL}, 0 };
+    ERROR_MANAGER(addQuery(&plan, &QUERY1, "query1.csv"),INVALID_PATH,media,INVALID_PATH)
+    ERROR_MANAGER(addQuery(&plan, &QUERY2, "query2.csv"),INVALID_PATH,media,INVALID_PATH)
+    ERROR_MANAGER(addQuery(&plan, &QUERY3, "query3.csv"),INVALID_PATH,media,INVALID_PATH)
+    /// En modo MEDIA_AGGREGATE no se guardan las mas votadas de cada genero.
+    if (options.mode == MEDIA_FULL)
+        ERROR_MANAGER(addQuery(&plan, &QUERY4, "query4.csv"),INVALID_PATH,media,INVALID_PATH)
+    if (options.pairs)
+        ERROR_MANAGER(addQuery(&plan, &QUERY5, "query5.csv"),INVALID_PATH,media,INVALID_PATH)
+    runQueryPlan(media, &plan);
+    endPhase(PHASE_QUERIES, &mark);
 
+    TMediaStats mediaStats;
+    int hasStats = options.stats && getMediaStats(media, &mediaStats) == 1;
     freeMediaADT(media);
+    endPhase(PHASE_FREE, &mark);
+
+    if (options.stats)
+        printStats(&options, rows, hasStats ? &mediaStats : NULL);
 
     return 0;
 }
 
+int parseArguments(int argc, char * argv[], TOptions * options)
+{
+    options->filePath = NULL;
+    options->loader = LOADER_STDIO;
+    options->advice = POSIX_MADV_SEQUENTIAL;
+    options->readahead = 0;
+    options->throughput = 0;
+    options->threads = 1;
+    options->snapshot = NULL;
+    options->deltasCount = 0;
+    options->topK = DEFAULT_TOP_K;
+    options->stats = 0;
+    options->mode = MEDIA_FULL;
+    options->pairs = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mmap") == 0)
+            options->loader = LOADER_MMAP;
+        else if (strcmp(argv[i], "--pipeline") == 0)
+            options->loader = LOADER_PIPELINE;
+        else if (strncmp(argv[i], "--madvise=", 10) == 0) {
+            const char * advice = argv[i] + 10;
+            if (strcmp(advice, "normal") == 0)
+                options->advice = POSIX_MADV_NORMAL;
+            else if (strcmp(advice, "sequential") == 0)
+                options->advice = POSIX_MADV_SEQUENTIAL;
+            else if (strcmp(advice, "random") == 0)
+                options->advice = POSIX_MADV_RANDOM;
+            else if (strcmp(advice, "willneed") == 0)
+                options->advice = POSIX_MADV_WILLNEED;
+            else
+                return INVALID_ARGS;
+        }
+        else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            /// La carga en paralelo requiere el archivo mapeado en memoria.
+            options->threads = (size_t)atol(argv[i] + 10);
+            options->loader = LOADER_MMAP;
+            if (options->threads == 0 || options->threads > MAX_THREADS)
+                return INVALID_ARGS;
+        }
+        else if (strcmp(argv[i], "--throughput") == 0)
+            options->throughput = 1;
+        else if (strcmp(argv[i], "--stats") == 0)
+            options->stats = 1;
+        else if (strcmp(argv[i], "--aggregate") == 0)
+            options->mode = MEDIA_AGGREGATE;
+        else if (strcmp(argv[i], "--pairs") == 0)
+            options->pairs = 1;
+        else if (strncmp(argv[i], "--readahead=", 12) == 0)
+            options->readahead = (size_t)atol(argv[i] + 12) * 1024 * 1024;
+        else if (strncmp(argv[i], "--snapshot=", 11) == 0 && argv[i][11] != '\0')
+            options->snapshot = argv[i] + 11;
+        else if (strncmp(argv[i], "--delta=", 8) == 0 && argv[i][8] != '\0') {
+            if (options->deltasCount == MAX_DELTAS)
+                return INVALID_ARGS;
+            options->deltas[options->deltasCount++] = argv[i] + 8;
+        }
+        else if (strncmp(argv[i], "--top=", 6) == 0) {
+            options->topK = (size_t)atol(argv[i] + 6);
+            if (options->topK == 0 || options->topK > MAX_TOP_K)
+                return INVALID_ARGS;
+        }
+        else if (argv[i][0] == '-' && argv[i][1] == '-')
+            return INVALID_ARGS;
+        else
+            options->filePath = argv[i];
+    }
+    if (options->mode == MEDIA_AGGREGATE && options->deltasCount > 0)
+        return INVALID_ARGS;
+    return options->filePath == NULL ? INVALID_ARGS : 1;
+}
+
+int isSnapshotFresh(const char * snapshot, const char * filePath)
+{
+    struct stat snapshotInfo, fileInfo;
+    /// La entrada estandar no tiene fecha de modificacion, por lo que siempre se vuelve a cargar.
+    if (stat(snapshot, &snapshotInfo) != 0 || strcmp(filePath, STDIN_PATH) == 0)
+        return 0;
+    /// Si el .csv no existe, el snapshot es la unica fuente disponible.
+    if (stat(filePath, &fileInfo) != 0)
+        return 1;
+    return snapshotInfo.st_mtime >= fileInfo.st_mtime;
+}
+
 contentType getContentType ( TContent content )
 {
     COMPARE_TYPES(content.titleType,"movie",CONTENTTYPE_MOVIE)
@@ -129,7 +604,7 @@ contentType getContentType ( TContent content )
     return (contentType)CONTENTTYPE_ERROR;
 }
 
-int getDataFromFile(mediaADT media, const char * filePath){
+size_t getDataFromFile(mediaADT media, const char * filePath){
 
     /// Se crea el buffer donde se almacenará temporalmente la linea obtenida durante la copia
     char buffer[BUFFER_SIZE];
@@ -141,7 +616,9 @@ int getDataFromFile(mediaADT media, const char * filePath){
     /// Se obtiene la primera linea del archivo, la cual se espera que sea el encabezado por lo que es ignorada
     fgets(buffer, BUFFER_SIZE, file);
     int out;
+    size_t rows = 0;
     while (fgets(buffer, BUFFER_SIZE, file)){ /// Se obtienen las demas lineas del archivo
+        rows++;
 
         /// Se utiliza un dato tipo TContent auxiliar, para almacenar la información y luego enviarla a la función addContent 
         TContent new = createContent(buffer, ";");
@@ -169,9 +646,417 @@ int getDataFromFile(mediaADT media, const char * filePath){
     ///Se finaliza la lectura del archivo.
     fclose(file);
 
+    return rows;
+}
+
+size_t getDataFromMappedFile(mediaADT media, const TOptions * options)
+{
+    int fd = open(options->filePath, O_RDONLY);
+    ERROR_MANAGER(fd,-1,media,INVALID_PATH)
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        /// Un archivo vacio no tiene contenido para cargar (mmap no admite longitud 0).
+        close(fd);
+        return 0;
+    }
+    size_t size = (size_t)info.st_size;
+    const char * data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    ERROR_MANAGER(data,MAP_FAILED,media,INVALID_PATH)
+    posix_madvise((void *)data, size, options->advice);
+
+    /// Se ignora el encabezado.
+    const char * end = data + size;
+    const char * block = memchr(data, '\n', size);
+    block = block == NULL ? end : block + 1;
+
+    /// Se procesa el archivo por ventanas de "readahead" bytes cortadas en fin de linea, pidiendo cada ventana
+    /// por adelantado. Sin readahead, el archivo completo es una unica ventana.
+    size_t pageMask = ~((size_t)sysconf(_SC_PAGESIZE) - 1);
+    size_t rows = 0;
+    while (block < end) {
+        const char * blockEnd = end;
+        if (options->readahead > 0 && (size_t)(end - block) > options->readahead) {
+            size_t pageOffset = (size_t)(block - data) & pageMask;
+            posix_madvise((void *)(data + pageOffset), options->readahead, POSIX_MADV_WILLNEED);
+            const char * newLine = memchr(block + options->readahead, '\n', end - block - options->readahead);
+            blockEnd = newLine == NULL ? end : newLine + 1;
+        }
+        if (options->threads > 1)
+            rows += parseRowsParallel(media, block, blockEnd - block, options->threads);
+        else
+            rows += loadRows(media, block, blockEnd - block);
+        block = blockEnd;
+    }
+
+    munmap((void *)data, size);
+    return rows;
+}
+
+/**
+ * @brief Funcion auxiliar que aplica las filas de un archivo de novedades ya leido, ignorando el encabezado.
+ */
+static size_t applyDeltaRows(mediaADT media, const char * data, size_t size)
+{
+    const char * block = memchr(data, '\n', size);
+    return block == NULL ? 0 : parseRows(block + 1, data + size - block - 1, updateRow, media);
+}
+
+/**
+ * @brief Funcion auxiliar que descomprime un archivo completo en memoria.
+ *
+ * @param media ADT creado para el manejo de peliculas/series (se libera si se produce un error fatal).
+ * @param filePath Archivo comprimido.
+ * @param size Cantidad de bytes descomprimidos.
+ * @return Contenido descomprimido, que debe liberarse con free.
+ */
+static char * readWholeStream(mediaADT media, const char * filePath, size_t * size)
+{
+    streamADT stream = newStreamADT(filePath);
+    ERROR_MANAGER(stream,NULL,media,INVALID_PATH)
+    size_t capacity = READ_BLOCK, used = 0, n;
+    char * data = malloc(capacity);
+    while (data != NULL && (n = streamRead(stream, data + used, capacity - used)) > 0) {
+        used += n;
+        if (used == capacity) {
+            char * bigger = realloc(data, capacity * 2);
+            if (bigger == NULL)
+                free(data);
+            data = bigger;
+            capacity *= 2;
+        }
+    }
+    int failed = streamError(stream);
+    freeStreamADT(stream);
+    ERROR_MANAGER(data,NULL,media,MEM_ERROR)
+    if (failed) {
+        free(data);
+        errorManager(INVALID_INPUT, media);
+    }
+    *size = used;
+    return data;
+}
+
+size_t applyDeltaFile(mediaADT media, const char * filePath)
+{
+    /// Los archivos de novedades comprimidos se descomprimen completos en memoria; los demas se mapean.
+    streamFormat format = detectStreamFormat(filePath);
+    ERROR_MANAGER(isStreamFormatSupported(format),0,media,INVALID_INPUT)
+    if (format != STREAM_PLAIN) {
+        size_t size;
+        char * data = readWholeStream(media, filePath, &size);
+        size_t rows = applyDeltaRows(media, data, size);
+        free(data);
+        return rows;
+    }
+
+    int fd = open(filePath, O_RDONLY);
+    ERROR_MANAGER(fd,-1,media,INVALID_PATH)
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    size_t size = (size_t)info.st_size;
+    const char * data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    ERROR_MANAGER(data,MAP_FAILED,media,INVALID_PATH)
+    posix_madvise((void *)data, size, POSIX_MADV_SEQUENTIAL);
+
+    size_t rows = applyDeltaRows(media, data, size);
+
+    munmap((void *)data, size);
+    return rows;
+}
+
+size_t parseRowsParallel(mediaADT media, const char * data, size_t len, size_t threads)
+{
+    TShard shards[MAX_THREADS];
+    const char * end = data + len;
+    size_t count = 0;
+
+    /// Se corta el bloque en porciones de tamaño similar, extendiendo cada una hasta el siguiente fin de linea.
+    while (data < end && count < threads) {
+        const char * shardEnd = end;
+        size_t target = len / threads;
+        if (count < threads - 1 && (size_t)(end - data) > target) {
+            const char * newLine = memchr(data + target, '\n', end - data - target);
+            shardEnd = newLine == NULL ? end : newLine + 1;
+        }
+        shards[count].data = data;
+        shards[count].len = shardEnd - data;
+        shards[count].rows = 0;
+        /// La primera porcion se carga directamente en el ADT destino para evitar una combinacion.
+        shards[count].media = count == 0 ? media : newMediaADT(MIN_YEAR, NULL, getMediaMode(media));
+        ERROR_MANAGER(shards[count].media,NULL,media,MEM_ERROR)
+        setTopK(shards[count].media, getTopK(media));
+        data = shardEnd;
+        count++;
+    }
+
+    for (size_t i = 1; i < count; i++)
+        if (pthread_create(&shards[i].thread, NULL, loadShard, &shards[i]) != 0)
+            loadShard(&shards[i]);  /// Si no se pudo crear el hilo, la porcion se carga en el hilo actual.
+    loadShard(&shards[0]);
+
+    size_t rows = shards[0].rows;
+    for (size_t i = 1; i < count; i++) {
+        pthread_join(shards[i].thread, NULL);
+        int out = mergeMediaADT(media, shards[i].media);
+        freeMediaADT(shards[i].media);
+        if (out != 1)
+            errorManager(out, media);
+        rows += shards[i].rows;
+    }
+    return rows;
+}
+
+void * loadShard(void * shard)
+{
+    TShard * aux = shard;
+    aux->rows = loadRows(aux->media, aux->data, aux->len);
+    return NULL;
+}
+
+size_t getDataFromPipeline(mediaADT media, const TOptions * options)
+{
+    TPipeline pipeline;
+    pipeline.stream = newStreamADT(options->filePath);
+    ERROR_MANAGER(pipeline.stream,NULL,media,INVALID_PATH)
+    pipeline.error = 0;
+    pipeline.blocks = newRingADT(RING_CAPACITY);
+    pipeline.batches = newRingADT(RING_CAPACITY);
+    ERROR_MANAGER(pipeline.blocks,NULL,media,MEM_ERROR)
+    ERROR_MANAGER(pipeline.batches,NULL,media,MEM_ERROR)
+
+    pthread_t reader, parser;
+    if (pthread_create(&reader, NULL, readStage, &pipeline) != 0)
+        errorManager(MEM_ERROR, media);
+    if (pthread_create(&parser, NULL, parseStage, &pipeline) != 0)
+        errorManager(MEM_ERROR, media);
+
+    /// Tercera etapa: se insertan los lotes en el orden en que fueron leidos.
+    size_t rows = 0;
+    TBatch * batch;
+    while ((batch = ringPop(pipeline.batches)) != NULL) {
+        insertBatch(media, batch);
+        rows += batch->count;
+        free(batch->block->data);
+        free(batch->block);
+        free(batch->rows);
+        free(batch->status);
+        free(batch);
+    }
+    pthread_join(reader, NULL);
+    pthread_join(parser, NULL);
+    freeStreamADT(pipeline.stream);
+
+    if (options->throughput) {
+        const char * names[] = {"lectura->separacion", "separacion->insercion"};
+        ringADT rings[] = {pipeline.blocks, pipeline.batches};
+        for (int i = 0; i < 2; i++) {
+            TRingStats stats = getRingStats(rings[i]);
+            fprintf(stderr, "%s: encolados %lu, esperas productor %lu, esperas consumidor %lu, "
+                            "profundidad maxima %lu, profundidad promedio %.2f\n", names[i],
+                    (unsigned long)stats.pushes, (unsigned long)stats.pushStalls, (unsigned long)stats.popStalls,
+                    (unsigned long)stats.maxDepth, stats.meanDepth);
+        }
+    }
+    freeRingADT(pipeline.blocks);
+    freeRingADT(pipeline.batches);
+    if (pipeline.error != 0)
+        errorManager(pipeline.error, media);
+    return rows;
+}
+
+void * readStage(void * pipeline)
+{
+    TPipeline * aux = pipeline;
+    size_t capacity = READ_BLOCK, used = 0;
+    char * buffer = malloc(capacity);
+    int isHeader = 1, eof = 0;
+
+    while (buffer != NULL && !eof) {
+        size_t n = streamRead(aux->stream, buffer + used, capacity - used);
+        used += n;
+        eof = n == 0;
+
+        /// Se busca el ultimo fin de linea; lo que sigue pasa al proximo bloque.
+        size_t blockLen = used;
+        while (blockLen > 0 && buffer[blockLen - 1] != '\n')
+            blockLen--;
+        if (eof)
+            blockLen = used;
+        else if (blockLen == 0) {
+            /// Si la linea no entra en el buffer, se agranda el mismo.
+            if (used == capacity) {
+                char * bigger = realloc(buffer, capacity * 2);
+                if (bigger == NULL)
+                    break;
+                buffer = bigger;
+                capacity *= 2;
+            }
+            continue;
+        }
+
+        /// Se ignora el encabezado.
+        size_t start = 0;
+        if (isHeader) {
+            while (start < blockLen && buffer[start++] != '\n')
+                ;
+            isHeader = 0;
+        }
+
+        char * next = malloc(capacity);
+        if (next == NULL)
+            break;
+        memcpy(next, buffer + blockLen, used - blockLen);
+        TBlock * block = malloc(sizeof(TBlock));
+        if (block == NULL) {
+            free(next);
+            break;
+        }
+        if (start > 0)
+            memmove(buffer, buffer + start, blockLen - start);
+        block->data = buffer;
+        block->len = blockLen - start;
+        ringPush(aux->blocks, block);
+        buffer = next;
+        used -= blockLen;
+    }
+
+    if (!eof)
+        aux->error = MEM_ERROR;
+    else if (streamError(aux->stream))
+        aux->error = INVALID_INPUT;
+    free(buffer);
+    ringClose(aux->blocks);
+    return NULL;
+}
+
+/**
+ * @brief Funcion auxiliar que agrega una fila separada por parseRows() al lote. De las filas de tipo invalido solo se
+ * guarda su estado, para informarlas en orden al insertar el lote. @see rowCallback
+ */
+static void addToBatch(void * context, int status, const TRawContent * row)
+{
+    TBatch * batch = context;
+    if (batch->rows == NULL)
+        return;
+    if (batch->count % BATCH_BLOCK == 0) {
+        TRawContent * rows = realloc(batch->rows, sizeof(TRawContent) * (batch->count + BATCH_BLOCK));
+        int * statuses = realloc(batch->status, sizeof(int) * (batch->count + BATCH_BLOCK));
+        if (statuses != NULL)
+            batch->status = statuses;
+        if (rows == NULL || statuses == NULL) {
+            free(rows == NULL ? batch->rows : rows);
+            batch->rows = NULL;
+            return;
+        }
+        batch->rows = rows;
+    }
+    if (status != CONTENTTYPE_ERROR)
+        batch->rows[batch->rowsCount++] = *row;
+    batch->status[batch->count++] = status;
+}
+
+/**
+ * @brief Funcion auxiliar que separa un bloque de lineas completas en un lote de filas.
+ *
+ * @param batch Lote a completar. Si se produce un error de memoria, el lote queda sin memoria reservada.
+ * @param data Comienzo del bloque.
+ * @param len Longitud del bloque.
+ * @return 1 si se separo correctamente o MEM_ERROR si se produjo un error de memoria.
+ */
+static int parseBatch(TBatch * batch, const char * data, size_t len)
+{
+    /// Se reserva el primer bloque de filas para distinguirlo de un error de memoria (rows en NULL).
+    batch->rows = malloc(sizeof(TRawContent) * BATCH_BLOCK);
+    batch->status = malloc(sizeof(int) * BATCH_BLOCK);
+    batch->rowsCount = 0;
+    batch->count = 0;
+    if (batch->rows != NULL && batch->status != NULL)
+        parseRows(data, len, addToBatch, batch);
+    if (batch->rows == NULL || batch->status == NULL) {
+        free(batch->rows);
+        free(batch->status);
+        return MEM_ERROR;
+    }
     return 1;
 }
 
+void * parseStage(void * pipeline)
+{
+    TPipeline * aux = pipeline;
+    TBlock * block;
+    while ((block = ringPop(aux->blocks)) != NULL) {
+        TBatch * batch = malloc(sizeof(TBatch));
+        if (batch == NULL || parseBatch(batch, block->data, block->len) == MEM_ERROR) {
+            aux->error = MEM_ERROR;
+            free(block->data);
+            free(block);
+            free(batch);
+            continue;
+        }
+        batch->block = block;
+        ringPush(aux->batches, batch);
+    }
+    ringClose(aux->batches);
+    return NULL;
+}
+
+void insertBatch(mediaADT media, const TBatch * batch)
+{
+    int * results = malloc(sizeof(int) * (batch->rowsCount + 1));
+    ERROR_MANAGER(results,NULL,media,MEM_ERROR)
+    if (addContentBatch(media, batch->rows, batch->rowsCount, results) == MEM_ERROR) {
+        free(results);
+        errorManager(MEM_ERROR, media);
+    }
+    /// Las filas de tipo invalido no llegaron al TAD, por lo que sus errores se intercalan con los de las demas.
+    for (size_t i = 0, j = 0; i < batch->count; i++) {
+        int out = batch->status[i] == CONTENTTYPE_ERROR ? CONTENTTYPE_ERROR : results[j++];
+        if (out != 1)
+            errorManager(out, media);
+    }
+    free(results);
+}
+
+size_t loadRows(mediaADT media, const char * data, size_t len)
+{
+    const char * end = data + len;
+    size_t rows = 0;
+    while (data < end) {
+        const char * batchEnd = end;
+        if ((size_t)(end - data) > READ_BLOCK) {
+            const char * newLine = memchr(data + READ_BLOCK, '\n', end - data - READ_BLOCK);
+            batchEnd = newLine == NULL ? end : newLine + 1;
+        }
+        TBatch batch;
+        ERROR_MANAGER(parseBatch(&batch, data, batchEnd - data),MEM_ERROR,media,MEM_ERROR)
+        insertBatch(media, &batch);
+        rows += batch.count;
+        free(batch.rows);
+        free(batch.status);
+        data = batchEnd;
+    }
+    return rows;
+}
+
+void updateRow(void * context, int status, const TRawContent * row)
+{
+    mediaADT media = context;
+    if (status == CONTENTTYPE_ERROR) {
+        errorManager(CONTENTTYPE_ERROR, media);
+        return;
+    }
+    int out = updateContent(media, row);
+    if (out != 1)
+        errorManager(out, media);
+}
+
 char ** createGenresVec(char ** vec, char * string){
     char * token;
     token = strtok(string, ","); /// La funcion "tokeniza" el string para poder separarlo con el delimitador ","
@@ -224,6 +1109,11 @@ void errorManager ( int  error , mediaADT media )
         case INVALID_PATH:
             printf("El path ingresado es invalido\n");
             break;
+        case INVALID_ARGS:
+            printf("Uso: imdb [--mmap|--pipeline] [--madvise=normal|sequential|random|willneed] [--readahead=MB] "
+                   "[--threads=N] [--throughput] [--stats] [--aggregate] [--pairs] [--snapshot=archivo] "
+                   "[--delta=archivo ...] [--top=K] archivo.csv|-\n");
+            break;
         case MEM_ERROR:
             printf("Error en asignacion de memoria \n");
             break;
@@ -231,8 +1121,18 @@ void errorManager ( int  error , mediaADT media )
             printf("El iterador no puede avanzar\n");
             break;
         case CONTENTTYPE_ERROR:
+            STATS_COUNT(runStats.rejectedType);
             printf("Se ingreso un tipo de contenido invalido \n");
             break;
+        case INVALIDYEAR_ERROR:
+            STATS_COUNT(runStats.rejectedYear);
+            break;
+        case SNAPSHOT_ERROR:
+            printf("No se pudo guardar el snapshot\n");
+            break;
+        case INVALID_INPUT:
+            printf("El archivo de entrada esta comprimido en un formato no soportado o esta dañado\n");
+            break;
         default:
             break;
     }
@@ -243,104 +1143,263 @@ void errorManager ( int  error , mediaADT media )
      */
     if (IS_FATALERROR(error))
     {
-        if ( error != INVALID_PATH )
+        if ( error != INVALID_PATH && error != INVALID_ARGS && media != NULL )
             freeMediaADT(media);
         exit(EXIT_FAILURE);
     }
 }
 
-void query1(mediaADT media, char * filePath){
-    ///Se crea el archivo, se abre en modo "write" para escribir sobre el mismo.
-    FILE * file=fopen(filePath, "w");
-
-    ///Se agrega el header correspondiente al archivo.
-    fprintf(file, "year;films;series\n");
+void endPhase(phaseId phase, struct timespec * mark)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    runStats.phases[phase] += (now.tv_sec - mark->tv_sec) + (now.tv_nsec - mark->tv_nsec) / 1e9;
+    *mark = now;
+}
 
-    toBeginYear(media);
-    ///Se itera por años validos para obtener cantida de peliculas y series por año
-    while (hasNextYear(media)){
-        unsigned short year= nextYear(media);
-        ERROR_MANAGER(year,RANGE_ERROR,media,RANGE_ERROR)
-        size_t MYears= countContentByYear(media, year, CONTENTTYPE_MOVIE);
-        size_t SYears= countContentByYear(media, year, CONTENTTYPE_SERIES);
-        fprintf(file, "%u;%ld;%ld\n", year, MYears, SYears);
+void printStats(const TOptions * options, size_t rows, const TMediaStats * media)
+{
+    const char * names[PHASES_COUNT] = {"load_ms", "save_ms", "deltas_ms", "queries_ms", "free_ms"};
+    fprintf(stderr, "{\n  \"rows\": %lu,\n  \"rejected_content_type\": %lu,\n  \"rejected_invalid_year\": %lu,\n",
+            (unsigned long)rows, (unsigned long)runStats.rejectedType, (unsigned long)runStats.rejectedYear);
+    fprintf(stderr, "  \"threads\": %lu,\n  \"phases\": {", (unsigned long)options->threads);
+    for (int i = 0; i < PHASES_COUNT; i++)
+        fprintf(stderr, "%s\"%s\": %.3f", i == 0 ? "" : ", ", names[i], runStats.phases[i] * 1e3);
+    if (media == NULL) {
+        fprintf(stderr, "},\n  \"media\": null\n}\n");
+        return;
     }
-
-    ///Se finaliza la escritura del archivo.
-    fclose(file);
+    /// Los tiempos del TAD son la suma de los de todos los hilos de carga.
+    fprintf(stderr, "},\n  \"media\": {\n");
+    fprintf(stderr, "    \"rows_added\": %lu,\n    \"rows_corrected\": %lu,\n    \"rows_rejected\": %lu,\n"
+                    "    \"rows_invalid_year\": %lu,\n    \"contents_merged\": %lu,\n",
+            (unsigned long)media->rowsAdded, (unsigned long)media->rowsCorrected, (unsigned long)media->rowsRejected,
+            (unsigned long)media->rowsInvalidYear, (unsigned long)media->contentsMerged);
+    fprintf(stderr, "    \"arena_allocs\": %lu,\n    \"arena_bytes\": %lu,\n    \"table_growths\": %lu,\n"
+                    "    \"table_growth_bytes\": %lu,\n",
+            (unsigned long)media->arenaAllocs, (unsigned long)media->arenaBytes, (unsigned long)media->tableGrowths,
+            (unsigned long)media->tableGrowthBytes);
+    fprintf(stderr, "    \"genre_lookups\": %lu,\n    \"genre_probes\": %lu,\n    \"mean_genre_probes\": %.3f,\n",
+            (unsigned long)media->genreLookups, (unsigned long)media->genreProbes, media->meanGenreProbes);
+    fprintf(stderr, "    \"insert_ms\": %.3f,\n    \"correct_ms\": %.3f,\n    \"merge_ms\": %.3f,\n"
+                    "    \"save_ms\": %.3f,\n    \"load_ms\": %.3f\n  }\n}\n",
+            media->insertNs / 1e6, media->correctNs / 1e6, media->mergeNs / 1e6, media->saveNs / 1e6,
+            media->loadNs / 1e6);
 }
 
-void query2 ( mediaADT media , char * filePath )
-{
+int addQuery(TQueryPlan * plan, const TQuerySink * sink, const char * filePath){
+    if (plan->count == MAX_SINKS)
+        return RANGE_ERROR;
     ///Se crea el archivo, se abre en modo "write" para escribir sobre el mismo.
-    FILE * file = fopen(filePath,"w");
+    writerADT file = newWriterADT(filePath);
+    if (file == NULL)
+        return INVALID_PATH;
 
-    ///Se agrega el header correspondiende al archivo
-    fprintf(file,"year;genre;films\n");
+    ///Se agrega el header correspondiente al archivo.
+    writeText(file, sink->header);
+    plan->sinks[plan->count] = sink;
+    plan->files[plan->count++] = file;
+    return 1;
+}
 
-    toBeginYear(media);
-    ///Se itera por años validos para obtener los generos y cantidad peliculas por genero
-    while (hasNextYear(media))
-    {
-        unsigned int year = nextYear(media);
+void runQueryPlan(mediaADT media, TQueryPlan * plan){
+    int needsGenres = 0;
+    for (size_t i = 0; i < plan->count; i++)
+        needsGenres |= plan->sinks[i]->onGenre != NULL;
+
+    TYearCursor years;
+    toBeginYearCursor(media, &years);
+    ///Se itera por años validos una unica vez, entregando cada año y cada genero a todas las consultas.
+    while (hasNextYearCursor(media, &years)){
+        unsigned short year = nextYearCursor(media, &years);
         ERROR_MANAGER(year,RANGE_ERROR,media,RANGE_ERROR)
-        toBeginGenre(media,year);
-        ///Se itera por generos validos para obtener la cantidad de peliculas del genero actual
-        while(hasNextGenre(media))
-        {
-            char * genre = nextGenre(media);
+        for (size_t i = 0; i < plan->count; i++)
+            if (plan->sinks[i]->onYear != NULL)
+                plan->sinks[i]->onYear(plan->files[i], media, year);
+
+        if (!needsGenres)
+            continue;
+        TGenreCursor genres;
+        toBeginGenreCursor(media, &genres, year);
+        while (hasNextGenreCursor(media, &genres)){
+            char * genre = nextGenreCursor(media, &genres);
             ERROR_MANAGER(genre,NULL,media,RANGE_ERROR)
-            size_t countOfMovies = countContentByGenre(media,year,genre,CONTENTTYPE_MOVIE);
-
-            /** Se tiene año , genero y cantidad de peliculas para el par (año,genero). Se guarda la información en el
-              * archivo y se continua la iteracion. En caso de no haber peliculas no se imprime la linea.
-              */
-              if (countOfMovies != 0){
-                  fprintf(file,"%d;%s;%ld\n",year , genre , countOfMovies);
-              }
+            for (size_t i = 0; i < plan->count; i++)
+                if (plan->sinks[i]->onGenre != NULL)
+                    plan->sinks[i]->onGenre(plan->files[i], media, year, genre);
         }
     }
 
-    ///Se finaliza la escritura del archivo.
-    fclose(file);
+    ///Se finaliza la escritura de los archivos.
+    for (size_t i = 0; i < plan->count; i++)
+        closeWriterADT(plan->files[i]);
+    plan->count = 0;
 }
 
-void query3(mediaADT media, char * filePath){
-    ///Se crea el archivo, se abre en modo "write" para escribir sobre el mismo.
-    FILE * file = fopen(filePath, "w");
+void runQuery(mediaADT media, const TQuerySink * sink, const char * filePath){
+    TQueryPlan plan = { {NULL}, {NULL}, 0 };
+    ERROR_MANAGER(addQuery(&plan, sink, filePath),INVALID_PATH,media,INVALID_PATH)
+    runQueryPlan(media, &plan);
+}
 
-    ///En primer lugar, se añade el header al archivo.
-    fprintf(file,"startYear;film;votesFilm;ratingFilm;serie;votesSerie;ratingSerie\n");
+/**
+ * @brief Funcion auxiliar de QUERY1 que escribe la cantidad de peliculas y series de un año.
+ */
+static void query1Year(writerADT out, mediaADT media, unsigned short year){
+    size_t MYears= countContentByYear(media, year, CONTENTTYPE_MOVIE);
+    size_t SYears= countContentByYear(media, year, CONTENTTYPE_SERIES);
+    writeUnsigned(out, year);
+    writeChar(out, ';');
+    writeUnsigned(out, MYears);
+    writeChar(out, ';');
+    writeUnsigned(out, SYears);
+    writeChar(out, '\n');
+}
 
-    ///Se inicia el iterador por años.
-    toBeginYear(media);
-    while (hasNextYear(media)){ ///< Mientras aún existan años validos, se seguirá escribiendo el archivo.
-        unsigned short year = nextYear(media);
-        ERROR_MANAGER(year,RANGE_ERROR,media,RANGE_ERROR)
+const TQuerySink QUERY1 = { "year;films;series\n", query1Year, NULL };
 
-        ///Se obtiene la película y la serie más votada del año correspondiente.
-        TContent movie = mostVoted(media, year, CONTENTTYPE_MOVIE);
-        TContent series = mostVoted(media, year, CONTENTTYPE_SERIES);
+/**
+ * @brief Funcion auxiliar de QUERY2 que escribe la cantidad de peliculas de un genero en un año.
+ */
+static void query2Genre(writerADT out, mediaADT media, unsigned short year, const char * genre){
+    size_t countOfMovies = countContentByGenre(media,year,genre,CONTENTTYPE_MOVIE);
 
-        /**
-         * Se imprime en el archivo la información con el formato correspondiente.
-         * En caso de que no se obtenga el titulo original de la pelicula/serie, se imprimira en su lugar
-         * un simbolo especial indicando que no se obtuvo información sobre ese campo.
-         */
+    /** Se tiene año , genero y cantidad de peliculas para el par (año,genero). Se guarda la información en el
+      * archivo y se continua la iteracion. En caso de no haber peliculas no se imprime la linea.
+      */
+    if (countOfMovies != 0){
+        writeUnsigned(out, year);
+        writeChar(out, ';');
+        writeText(out, genre);
+        writeChar(out, ';');
+        writeUnsigned(out, countOfMovies);
+        writeChar(out, '\n');
+    }
+}
 
-        if (movie.primaryTitle[0] == '\0')
-            fprintf(file, "%d;\\N;\\N;\\N;%s;%lu;%.1f\n",year, series.primaryTitle, series.numVotes, series.averageRating);
+const TQuerySink QUERY2 = { "year;genre;films\n", NULL, query2Genre };
 
-        else if (series.primaryTitle[0] == '\0')
-            fprintf(file, "%d;%s;%lu;%.1f;\\N;\\N;\\N\n",year, movie.primaryTitle, movie.numVotes, movie.averageRating);
-                 
-        else
-            fprintf(file, "%d;%s;%lu;%.1f;%s;%lu;%.1f\n",year,
-                movie.primaryTitle, movie.numVotes, movie.averageRating,
-                series.primaryTitle, series.numVotes, series.averageRating);
+/**
+ * @brief Funcion auxiliar de QUERY3 que escribe titulo, votos y puntaje de un contenido, o "\\N" en cada campo si
+ * "undefined" es 1.
+ */
+static void writeBest(writerADT out, const TContent * content, int undefined){
+    if (undefined){
+        writeText(out, UNDEFINED_SYMBOL);
+        writeChar(out, ';');
+        writeText(out, UNDEFINED_SYMBOL);
+        writeChar(out, ';');
+        writeText(out, UNDEFINED_SYMBOL);
+        return;
+    }
+    writeText(out, content->primaryTitle);
+    writeChar(out, ';');
+    writeUnsigned(out, content->numVotes);
+    writeChar(out, ';');
+    writeDecimal(out, content->averageRating);
+}
+
+/**
+ * @brief Funcion auxiliar de QUERY3 que escribe la pelicula y la serie más votadas de un año.
+ */
+static void query3Year(writerADT out, mediaADT media, unsigned short year){
+    ///Se obtiene la película y la serie más votada del año correspondiente.
+    TContent movie = mostVoted(media, year, CONTENTTYPE_MOVIE);
+    TContent series = mostVoted(media, year, CONTENTTYPE_SERIES);
+
+    /**
+     * Se imprime en el archivo la información con el formato correspondiente.
+     * En caso de que no se obtenga el titulo original de la pelicula/serie, se imprimira en su lugar
+     * un simbolo especial indicando que no se obtuvo información sobre ese campo (solo en uno de los dos).
+     */
+    int noMovie = movie.primaryTitle[0] == '\0';
+    writeUnsigned(out, year);
+    writeChar(out, ';');
+    writeBest(out, &movie, noMovie);
+    writeChar(out, ';');
+    writeBest(out, &series, !noMovie && series.primaryTitle[0] == '\0');
+    writeChar(out, '\n');
+}
 
+const TQuerySink QUERY3 = { "startYear;film;votesFilm;ratingFilm;serie;votesSerie;ratingSerie\n", query3Year, NULL };
+
+/**
+ * @brief Funcion auxiliar de QUERY4 que escribe las peliculas o series mas votadas de un año o de un genero.
+ *
+ * @param out Archivo destino.
+ * @param media ADT creado para el manejo de películas/series.
+ * @param year Año a consultar.
+ * @param genre Genero a consultar, o NULL para todo el año.
+ * @param type Tipo de contenido a consultar.
+ */
+static void writeTop(writerADT out, mediaADT media, unsigned short year, const char * genre, contentType type){
+    TTopCursor top;
+    toBeginTopCursor(media, &top, year, genre, type);
+    for (size_t rank = 1; hasNextTopCursor(&top); rank++) {
+        TContent content = nextTopCursor(media, &top);
+        writeUnsigned(out, year);
+        writeChar(out, ';');
+        writeText(out, genre == NULL ? UNDEFINED_SYMBOL : genre);
+        writeChar(out, ';');
+        writeText(out, content.titleType);
+        writeChar(out, ';');
+        writeUnsigned(out, rank);
+        writeChar(out, ';');
+        writeText(out, content.primaryTitle);
+        writeChar(out, ';');
+        writeUnsigned(out, content.numVotes);
+        writeChar(out, ';');
+        writeDecimal(out, content.averageRating);
+        writeChar(out, '\n');
     }
+}
 
-    ///Se finaliza la escritura del archivo.
-    fclose(file);
+/**
+ * @brief Funciones auxiliares de QUERY4: primero las mas votadas del año y luego las de cada genero.
+ */
+static void query4Year(writerADT out, mediaADT media, unsigned short year){
+    writeTop(out, media, year, NULL, CONTENTTYPE_MOVIE);
+    writeTop(out, media, year, NULL, CONTENTTYPE_SERIES);
 }
+
+static void query4Genre(writerADT out, mediaADT media, unsigned short year, const char * genre){
+    writeTop(out, media, year, genre, CONTENTTYPE_MOVIE);
+    writeTop(out, media, year, genre, CONTENTTYPE_SERIES);
+}
+
+const TQuerySink QUERY4 = { "startYear;genre;type;rank;primaryTitle;numVotes;averageRating\n", query4Year, query4Genre };
+
+/**
+ * @brief Funcion auxiliar de QUERY5 que escribe, para un genero de un año, las cantidades de peliculas y series que
+ * comparte con cada genero posterior del año.
+ */
+static void query5Genre(writerADT out, mediaADT media, unsigned short year, const char * genre){
+    TGenreCursor cursor;
+    if (toBeginGenreCursor(media, &cursor, year) != 1)
+        return;
+    /// El cursor recorre los generos en el mismo orden que la consulta, por lo que se saltean hasta "genre".
+    int after = 0;
+    while (hasNextGenreCursor(media, &cursor)) {
+        const char * paired = nextGenreCursor(media, &cursor);
+        if (!after) {
+            after = strcmp(paired, genre) == 0;
+            continue;
+        }
+        size_t movies = countContentByGenrePair(media, year, genre, paired, CONTENTTYPE_MOVIE);
+        size_t series = countContentByGenrePair(media, year, genre, paired, CONTENTTYPE_SERIES);
+        if (movies + series == 0)
+            continue;
+        writeUnsigned(out, year);
+        writeChar(out, ';');
+        writeText(out, genre);
+        writeChar(out, ';');
+        writeText(out, paired);
+        writeChar(out, ';');
+        writeUnsigned(out, movies);
+        writeChar(out, ';');
+        writeUnsigned(out, series);
+        writeChar(out, '\n');
+    }
+}
+
+const TQuerySink QUERY5 = { "year;genre;pairedGenre;films;series\n", NULL, query5Genre };
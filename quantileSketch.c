@@ -0,0 +1,84 @@
+#include "quantileSketch.h"
+
+/**
+ * @brief Funcion auxiliar que devuelve el intervalo de un puntaje: el puntaje redondeado a un decimal, por 10.
+ */
+static size_t ratingBin(float rating){
+    if (!(rating > 0))
+        return 0;
+    if (rating >= 10)
+        return RATING_BINS - 1;
+    return (size_t)(rating * 10 + 0.5f);
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve el intervalo de una duracion. A partir de RUNTIME_EXACT, cada potencia de 2
+ * [2^e, 2^(e+1)) se divide en RUNTIME_SUB intervalos iguales, indicados por los bits que siguen al mas significativo.
+ */
+static size_t runtimeBin(unsigned short runtime){
+    if (runtime < RUNTIME_EXACT)
+        return runtime;
+    size_t exponent = 0;
+    while ((runtime >> exponent) >= 2 * RUNTIME_SUB)
+        exponent++;
+    /// runtime >> exponent esta en [RUNTIME_SUB, 2 * RUNTIME_SUB); exponent es 1 para los valores desde RUNTIME_EXACT.
+    return RUNTIME_EXACT + (exponent - 1) * RUNTIME_SUB + ((runtime >> exponent) - RUNTIME_SUB);
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve el valor que representa a un intervalo de duracion (su punto medio).
+ */
+static double runtimeValue(size_t bin){
+    if (bin < RUNTIME_EXACT)
+        return bin;
+    size_t exponent = (bin - RUNTIME_EXACT) / RUNTIME_SUB + 1;
+    size_t low = (RUNTIME_SUB + (bin - RUNTIME_EXACT) % RUNTIME_SUB) << exponent;
+    return low + ((1UL << exponent) - 1) / 2.0;
+}
+
+/**
+ * @brief Funcion auxiliar que devuelve el primer intervalo en el que la cantidad acumulada alcanza el rango del
+ * cuantil "q" (ceil(q * count), al menos 1).
+ */
+static size_t quantileBin(const unsigned int * bins, size_t size, size_t count, double q){
+    double target = q * count;
+    size_t rank = (size_t)target;
+    if (rank < target || rank == 0)
+        rank++;
+    size_t accum = 0, bin = 0;
+    while (bin < size - 1 && (accum += bins[bin]) < rank)
+        bin++;
+    return bin;
+}
+
+void sketchAdd(TQuantileSketch * sketch, float rating, unsigned short runtime){
+    sketch->rating[ratingBin(rating)]++;
+    sketch->runtime[runtimeBin(runtime)]++;
+    sketch->count++;
+}
+
+void sketchRemove(TQuantileSketch * sketch, float rating, unsigned short runtime){
+    sketch->rating[ratingBin(rating)]--;
+    sketch->runtime[runtimeBin(runtime)]--;
+    sketch->count--;
+}
+
+void sketchMerge(TQuantileSketch * to, const TQuantileSketch * from){
+    for (size_t i = 0; i < RATING_BINS; i++)
+        to->rating[i] += from->rating[i];
+    for (size_t i = 0; i < RUNTIME_BINS; i++)
+        to->runtime[i] += from->runtime[i];
+    to->count += from->count;
+}
+
+double sketchRatingQuantile(const TQuantileSketch * sketch, double q){
+    if (sketch->count == 0 || !(q >= 0 && q <= 1))
+        return -1;
+    return quantileBin(sketch->rating, RATING_BINS, sketch->count, q) / 10.0;
+}
+
+double sketchRuntimeQuantile(const TQuantileSketch * sketch, double q){
+    if (sketch->count == 0 || !(q >= 0 && q <= 1))
+        return -1;
+    return runtimeValue(quantileBin(sketch->runtime, RUNTIME_BINS, sketch->count, q));
+}
@@ -0,0 +1,63 @@
+#ifndef TPEFINAL_QUANTILESKETCH_H
+#define TPEFINAL_QUANTILESKETCH_H
+
+#include <stddef.h>
+
+#define RATING_BINS 101       /**< @def Cantidad de intervalos de puntaje (de 0.0 a 10.0, de a 0.1)               */
+#define RUNTIME_EXACT 32      /**< @def Duraciones menores a este valor tienen un intervalo propio                 */
+#define RUNTIME_SUB 16        /**< @def Cantidad de intervalos en que se divide cada potencia de 2 de duracion     */
+#define RUNTIME_BINS (RUNTIME_EXACT + 11 * RUNTIME_SUB) /**< @def Intervalos de duracion (hasta 65535 minutos) */
+
+/**
+ * @brief Sketch de cuantiles de puntaje y duracion de un conjunto de peliculas/series.
+ *
+ * @details Es un histograma de tamaño fijo (algo mas de 1 KB) que no depende de la cantidad de valores: el puntaje
+ * se guarda con su resolucion de 0.1 (exacto para puntajes con un decimal) y la duracion en intervalos exactos hasta
+ * RUNTIME_EXACT minutos y luego logaritmicos, con error relativo menor a 1/32. A diferencia de t-digest o KLL, dos
+ * sketches se combinan sumando sus intervalos sin perder precision y un valor puede quitarse exactamente, por lo que
+ * admite corregir contenidos ya añadidos.
+ */
+typedef struct quantileSketch {
+    size_t count;                         /**< Cantidad de valores añadidos            */
+    unsigned int rating[RATING_BINS];     /**< Cantidad de valores por puntaje         */
+    unsigned int runtime[RUNTIME_BINS];   /**< Cantidad de valores por duracion        */
+} TQuantileSketch;
+
+/**
+ * @brief Funcion que añade el puntaje y la duracion de una pelicula/serie a un sketch.
+ *
+ * @param sketch Sketch a actualizar.
+ * @param rating Puntaje (se limita a [0, 10]).
+ * @param runtime Duracion en minutos.
+ */
+void sketchAdd(TQuantileSketch * sketch, float rating, unsigned short runtime);
+
+/**
+ * @brief Funcion que quita de un sketch el puntaje y la duracion de una pelicula/serie añadida previamente.
+ *
+ * @param sketch Sketch a actualizar.
+ * @param rating Puntaje con el que se añadio.
+ * @param runtime Duracion con la que se añadio.
+ */
+void sketchRemove(TQuantileSketch * sketch, float rating, unsigned short runtime);
+
+/**
+ * @brief Funcion que acumula en "to" todos los valores de "from".
+ *
+ * @param to Sketch destino.
+ * @param from Sketch a combinar.
+ */
+void sketchMerge(TQuantileSketch * to, const TQuantileSketch * from);
+
+/**
+ * @brief Funciones que devuelven el cuantil "q" (de rango mas cercano) del puntaje o de la duracion de un sketch.
+ *
+ * @param sketch Sketch a consultar.
+ * @param q Cuantil entre 0 y 1 (por ejemplo, 0.5 para la mediana).
+ * @return Valor del cuantil (con la precision descripta en TQuantileSketch).
+ * @return -1 si el sketch esta vacio o q no esta entre 0 y 1.
+ */
+double sketchRatingQuantile(const TQuantileSketch * sketch, double q);
+double sketchRuntimeQuantile(const TQuantileSketch * sketch, double q);
+
+#endif //TPEFINAL_QUANTILESKETCH_H
@@ -0,0 +1,100 @@
+#define _POSIX_C_SOURCE 200112L
+#include "ringBuffer.h"
+#include <sched.h>
+
+#define CACHE_LINE 64     /**< @def Tamaño de linea de cache, para que productor y consumidor no compartan lineas */
+
+/**
+ * @brief Cola circular para un productor y un consumidor. "tail" solo lo escribe el productor y "head" solo el
+ * consumidor; cada uno lee el indice del otro con semantica acquire/release, sin necesidad de locks.
+ */
+typedef struct ringCDT {
+    void ** items;                  /**< Vector circular de elementos                         */
+    size_t mask;                    /**< capacidad - 1 (la capacidad es potencia de 2)        */
+    char padHead[CACHE_LINE];
+    size_t head;                    /**< Proxima posicion a desencolar (consumidor)           */
+    size_t popStalls;               /**< Esperas del consumidor                               */
+    char padTail[CACHE_LINE];
+    size_t tail;                    /**< Proxima posicion a encolar (productor)               */
+    int closed;                     /**< 1 si el productor no encolara mas elementos          */
+    size_t pushStalls;              /**< Esperas del productor                                */
+    size_t maxDepth;                /**< Maxima profundidad observada por el productor        */
+    size_t depthSum;                /**< Suma de profundidades observadas al encolar          */
+} ringCDT;
+
+ringADT newRingADT(size_t capacity)
+{
+    ringADT new = calloc(1, sizeof(ringCDT));
+    if (new == NULL)
+        return NULL;
+    size_t size = 1;
+    while (size < capacity)
+        size *= 2;
+    if ((new->items = malloc(sizeof(void *) * size)) == NULL) {
+        free(new);
+        return NULL;
+    }
+    new->mask = size - 1;
+    return new;
+}
+
+void ringPush(ringADT ring, void * item)
+{
+    size_t tail = ring->tail;
+    size_t depth = tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (depth > ring->mask) {
+        /// Cola llena: el productor espera a que el consumidor libere lugar.
+        ring->pushStalls++;
+        while ((depth = tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) > ring->mask)
+            sched_yield();
+    }
+    if (depth + 1 > ring->maxDepth)
+        ring->maxDepth = depth + 1;
+    ring->depthSum += depth + 1;
+
+    ring->items[tail & ring->mask] = item;
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+void * ringPop(ringADT ring)
+{
+    size_t head = ring->head;
+    if (head == __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)) {
+        /// Cola vacia: el consumidor espera a que el productor encole o cierre la cola.
+        ring->popStalls++;
+        while (head == __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)) {
+            if (__atomic_load_n(&ring->closed, __ATOMIC_ACQUIRE)) {
+                /// El cierre se publica despues del ultimo elemento, por lo que se vuelve a verificar la cola.
+                if (head == __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE))
+                    return NULL;
+                break;
+            }
+            sched_yield();
+        }
+    }
+    void * item = ring->items[head & ring->mask];
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return item;
+}
+
+void ringClose(ringADT ring)
+{
+    __atomic_store_n(&ring->closed, 1, __ATOMIC_RELEASE);
+}
+
+TRingStats getRingStats(const ringADT ring)
+{
+    TRingStats stats;
+    stats.pushes = ring->tail;
+    stats.pushStalls = ring->pushStalls;
+    stats.popStalls = ring->popStalls;
+    stats.maxDepth = ring->maxDepth;
+    stats.meanDepth = ring->tail == 0 ? 0 : (double)ring->depthSum / ring->tail;
+    return stats;
+}
+
+void freeRingADT(ringADT ring)
+{
+    free(ring->items);
+    free(ring);
+}
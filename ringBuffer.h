@@ -0,0 +1,67 @@
+#ifndef TPEFINAL_RINGBUFFER_H
+#define TPEFINAL_RINGBUFFER_H
+
+#include <stdlib.h>
+
+typedef struct ringCDT * ringADT;
+
+/**
+ * @brief Contadores de uso de un ringADT, para identificar que etapa de un pipeline es el cuello de botella.
+ */
+typedef struct ringStats {
+    size_t pushes;          /**< Cantidad de elementos encolados                                        */
+    size_t pushStalls;      /**< Cantidad de veces que el productor encontro la cola llena y tuvo que esperar */
+    size_t popStalls;       /**< Cantidad de veces que el consumidor encontro la cola vacia y tuvo que esperar */
+    size_t maxDepth;        /**< Maxima cantidad de elementos encolados en simultaneo                   */
+    double meanDepth;       /**< Cantidad promedio de elementos encolados al momento de encolar         */
+} TRingStats;
+
+/**
+ * @brief Funcion que crea una cola acotada sin locks para un unico productor y un unico consumidor.
+ *
+ * @details La cola guarda punteros. Si se llena, el productor espera (backpressure) hasta que el consumidor libere
+ * lugar; si esta vacia, el consumidor espera hasta que el productor encole o cierre la cola.
+ *
+ * @param capacity Cantidad maxima de elementos. Se redondea a la siguiente potencia de 2.
+ * @return ringADT creado o NULL si no se pudo reservar memoria.
+ */
+ringADT newRingADT(size_t capacity);
+
+/**
+ * @brief Funcion que encola un elemento, esperando si la cola esta llena. Solo puede llamarla el productor.
+ *
+ * @param ring Cola.
+ * @param item Elemento a encolar (distinto de NULL).
+ */
+void ringPush(ringADT ring, void * item);
+
+/**
+ * @brief Funcion que desencola un elemento, esperando si la cola esta vacia. Solo puede llamarla el consumidor.
+ *
+ * @param ring Cola.
+ * @return Elemento desencolado o NULL si la cola fue cerrada y no quedan elementos.
+ */
+void * ringPop(ringADT ring);
+
+/**
+ * @brief Funcion que indica al consumidor que no se encolaran mas elementos. Solo puede llamarla el productor.
+ *
+ * @param ring Cola.
+ */
+void ringClose(ringADT ring);
+
+/**
+ * @brief Funcion que devuelve los contadores de uso de la cola. Debe llamarse una vez que ambos extremos terminaron.
+ *
+ * @param ring Cola.
+ */
+TRingStats getRingStats(const ringADT ring);
+
+/**
+ * @brief Funcion que libera los recursos reservados por la cola (no libera los elementos encolados).
+ *
+ * @param ring Cola.
+ */
+void freeRingADT(ringADT ring);
+
+#endif //TPEFINAL_RINGBUFFER_H
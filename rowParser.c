@@ -0,0 +1,224 @@
+#include "rowParser.h"
+#include <string.h>
+#include <strings.h>
+#include <limits.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define SCAN_BLOCK 64          /**< @def Cantidad de bytes analizados por cada llamada a scanBlock */
+#define MAX_RATING_DIGITS 9    /**< @def Maxima cantidad de digitos que se acumulan para un puntaje */
+
+#define IS_NULL_FIELD(F) ((F).len == 2 && (F).str[0] == '\\' && (F).str[1] == 'N')
+#define IS_DIGIT(C) ((unsigned char)((C) - '0') < 10)
+
+/**
+ * @brief Estado del separador de filas mientras se recorren los delimitadores.
+ */
+typedef struct rowState {
+    TSlice fields[FIELDS_COUNT];   /**< Campos no vacios de la fila actual             */
+    size_t count;                  /**< Cantidad de campos no vacios encontrados        */
+    size_t fieldStart;             /**< Posicion donde comienza el campo actual         */
+    size_t genreStart;             /**< Posicion donde comienza el genero actual        */
+    TRawContent row;               /**< Fila que se entrega al usuario                  */
+} TRowState;
+
+/**
+ * @brief Funcion auxiliar que obtiene mascaras de bits con las posiciones de ";", "," y "\n" en hasta 64 bytes.
+ *
+ * @details El bit i de cada mascara vale 1 si el byte i del bloque es el delimitador correspondiente. Si el bloque
+ * tiene menos de 64 bytes, se copia a un buffer completado con ceros.
+ */
+static void scanBlock(const char * data, size_t len, unsigned long long * semi, unsigned long long * comma,
+                      unsigned long long * newLine)
+{
+    char padded[SCAN_BLOCK];
+    if (len < SCAN_BLOCK) {
+        memset(padded, 0, SCAN_BLOCK);
+        memcpy(padded, data, len);
+        data = padded;
+    }
+#if defined(__AVX2__)
+    const __m256i semiV = _mm256_set1_epi8(';'), commaV = _mm256_set1_epi8(','), newLineV = _mm256_set1_epi8('\n');
+    *semi = *comma = *newLine = 0;
+    for (int i = 0; i < SCAN_BLOCK; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)(data + i));
+        *semi |= (unsigned long long)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, semiV)) << i;
+        *comma |= (unsigned long long)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, commaV)) << i;
+        *newLine |= (unsigned long long)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newLineV)) << i;
+    }
+#elif defined(__SSE2__)
+    const __m128i semiV = _mm_set1_epi8(';'), commaV = _mm_set1_epi8(','), newLineV = _mm_set1_epi8('\n');
+    *semi = *comma = *newLine = 0;
+    for (int i = 0; i < SCAN_BLOCK; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(data + i));
+        *semi |= (unsigned long long)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, semiV)) << i;
+        *comma |= (unsigned long long)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, commaV)) << i;
+        *newLine |= (unsigned long long)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newLineV)) << i;
+    }
+#else
+    *semi = *comma = *newLine = 0;
+    for (int i = 0; i < SCAN_BLOCK; i++) {
+        *semi |= (unsigned long long)(data[i] == ';') << i;
+        *comma |= (unsigned long long)(data[i] == ',') << i;
+        *newLine |= (unsigned long long)(data[i] == '\n') << i;
+    }
+#endif
+}
+
+/**
+ * @brief Funcion auxiliar que agrega un genero a la fila si no esta vacio.
+ */
+static void addGenre(TRowState * state, const char * data, const size_t from, const size_t to)
+{
+    if (to > from && state->row.genresCount < MAX_GENRES) {
+        state->row.genres[state->row.genresCount].str = data + from;
+        state->row.genres[state->row.genresCount++].len = to - from;
+    }
+}
+
+/**
+ * @brief Funcion auxiliar que cierra el campo actual en la posicion "pos" (sin incluirla).
+ */
+static void endField(TRowState * state, const char * data, const size_t pos)
+{
+    size_t len = pos - state->fieldStart;
+    if (len > 0 && state->count < FIELDS_COUNT) {
+        if (state->count == GENRES_FIELD)
+            addGenre(state, data, state->genreStart, pos);
+        state->fields[state->count].str = data + state->fieldStart;
+        state->fields[state->count++].len = len;
+    }
+    state->fieldStart = state->genreStart = pos + 1;
+}
+
+/**
+ * @brief Funcion auxiliar que completa el TRawContent con los campos de la fila y lo entrega al usuario.
+ */
+static void endRow(TRowState * state, rowCallback callback, void * context)
+{
+    TRawContent * row = &state->row;
+    int status = CONTENTTYPE_ERROR;
+    if (state->count == FIELDS_COUNT) {
+        TSlice type = state->fields[0];
+        if (type.len == 5 && strncasecmp(type.str, "movie", 5) == 0)
+            status = CONTENTTYPE_MOVIE;
+        else if (type.len == 8 && strncasecmp(type.str, "tvSeries", 8) == 0)
+            status = CONTENTTYPE_SERIES;
+    }
+    if (status != CONTENTTYPE_ERROR) {
+        unsigned long aux;
+        row->type = status;
+        row->primaryTitle = state->fields[1];
+        parseUnsigned(state->fields[2], &aux);
+        row->startYear = aux;
+        parseUnsigned(state->fields[3], &aux);
+        row->endYear = aux;
+        parseRating(state->fields[5], &row->averageRating);
+        parseUnsigned(state->fields[6], &row->numVotes);
+        parseUnsigned(state->fields[7], &aux);
+        row->runtimeMinutes = aux;
+    }
+    callback(context, status, row);
+    state->count = 0;
+    row->genresCount = 0;
+}
+
+size_t parseRows(const char * data, size_t len, rowCallback callback, void * context)
+{
+    TRowState state;
+    state.count = state.fieldStart = state.genreStart = 0;
+    state.row.genresCount = 0;
+    size_t rows = 0;
+    size_t rowStart = 0;
+
+    for (size_t base = 0; base < len; base += SCAN_BLOCK) {
+        unsigned long long semi, comma, newLine;
+        scanBlock(data + base, len - base, &semi, &comma, &newLine);
+        unsigned long long mask = semi | comma | newLine;
+
+        /// Se recorren solo las posiciones de los delimitadores, de menor a mayor.
+        while (mask != 0) {
+            unsigned long long bit = mask & (~mask + 1);
+            size_t pos = base + __builtin_ctzll(mask);
+            mask ^= bit;
+            if (pos >= len)
+                break;
+            if (comma & bit) {
+                /// Las comas solo separan dentro del campo de generos (los titulos pueden contenerlas).
+                if (state.count == GENRES_FIELD) {
+                    addGenre(&state, data, state.genreStart, pos);
+                    state.genreStart = pos + 1;
+                }
+                continue;
+            }
+            if (newLine & bit) {
+                size_t end = pos > rowStart && data[pos - 1] == '\r' ? pos - 1 : pos;
+                if (end > rowStart) {
+                    endField(&state, data, end);
+                    endRow(&state, callback, context);
+                    rows++;
+                }
+                rowStart = state.fieldStart = state.genreStart = pos + 1;
+                state.count = 0;
+                state.row.genresCount = 0;
+            }
+            else
+                endField(&state, data, pos);
+        }
+    }
+
+    /// La ultima linea puede no terminar en "\n".
+    if (rowStart < len) {
+        size_t end = data[len - 1] == '\r' ? len - 1 : len;
+        endField(&state, data, end);
+        endRow(&state, callback, context);
+        rows++;
+    }
+    return rows;
+}
+
+int parseUnsigned(const TSlice field, unsigned long * out)
+{
+    unsigned long value = 0;
+    size_t i = 0;
+    if (IS_NULL_FIELD(field)) {
+        *out = 0;
+        return 1;
+    }
+    for (; i < field.len && IS_DIGIT(field.str[i]); i++) {
+        unsigned int digit = field.str[i] - '0';
+        value = value > (ULONG_MAX - digit) / 10 ? ULONG_MAX : value * 10 + digit;
+    }
+    *out = value;
+    return i == field.len && i > 0;
+}
+
+int parseRating(const TSlice field, float * out)
+{
+    static const double POW10[MAX_RATING_DIGITS + 1] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+    unsigned long mantissa = 0;
+    size_t digits = 0, decimals = 0, i = 0;
+    int valid = 1;
+    if (IS_NULL_FIELD(field)) {
+        *out = 0;
+        return 1;
+    }
+    for (; i < field.len && IS_DIGIT(field.str[i]); i++)
+        if (digits < MAX_RATING_DIGITS) {
+            mantissa = mantissa * 10 + (field.str[i] - '0');
+            digits++;
+        }
+        else
+            valid = 0;
+    if (i < field.len && field.str[i] == '.')
+        for (i++; i < field.len && IS_DIGIT(field.str[i]); i++)
+            if (digits < MAX_RATING_DIGITS) {
+                mantissa = mantissa * 10 + (field.str[i] - '0');
+                digits++;
+                decimals++;
+            }
+    *out = (float)(mantissa / POW10[decimals]);
+    return valid && i == field.len && digits > 0;
+}
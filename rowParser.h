@@ -0,0 +1,58 @@
+#ifndef TPEFINAL_ROWPARSER_H
+#define TPEFINAL_ROWPARSER_H
+
+#include "mediaADT.h"
+
+#define FIELDS_COUNT 8        /**< @def Cantidad de campos por linea del archivo                                  */
+#define GENRES_FIELD 4        /**< @def Posicion del campo de generos (el unico que se separa tambien por ",")    */
+
+/**
+ * @brief Funcion que recibe cada fila separada por parseRows().
+ *
+ * @param context Puntero indicado por el usuario en parseRows().
+ * @param status CONTENTTYPE_MOVIE o CONTENTTYPE_SERIES si la fila es valida, CONTENTTYPE_ERROR si no lo es.
+ * @param row Fila separada en campos. Sus textos apuntan dentro del bloque recibido por parseRows(), por lo que
+ * solo son validos mientras el bloque exista. Si status es CONTENTTYPE_ERROR su contenido es indefinido.
+ */
+typedef void (*rowCallback)(void * context, int status, const TRawContent * row);
+
+/**
+ * @brief Funcion que separa un bloque de lineas completas (sin encabezado) en filas, sin copiar sus campos.
+ *
+ * @details Las posiciones de los delimitadores ";", "," y "\n" se buscan de a 64 bytes a la vez con instrucciones
+ * vectoriales (AVX2 o SSE2 segun como se compile, con una version escalar de respaldo). Al igual que strtok, los
+ * campos vacios se ignoran. Las lineas pueden tener cualquier longitud y se aceptan finales de linea "\r\n".
+ *
+ * @param data Comienzo del bloque.
+ * @param len Longitud del bloque. Si la ultima linea no termina en "\n", se procesa igualmente.
+ * @param callback Funcion que recibira cada fila no vacia.
+ * @param context Puntero que se pasara a callback.
+ * @return Cantidad de filas no vacias procesadas.
+ */
+size_t parseRows(const char * data, size_t len, rowCallback callback, void * context);
+
+/**
+ * @brief Funcion que convierte un campo en entero sin signo.
+ *
+ * @details Se convierten los digitos iniciales del campo (como atoi). El valor se satura en lugar de desbordar.
+ * El campo "\\N" se interpreta como 0.
+ *
+ * @param field Campo a convertir.
+ * @param out Valor obtenido.
+ * @return 1 si el campo es un numero valido o "\\N", 0 si contenia otros caracteres.
+ */
+int parseUnsigned(const TSlice field, unsigned long * out);
+
+/**
+ * @brief Funcion que convierte un puntaje en formato decimal ("7.3") en punto fijo, sin utilizar atof.
+ *
+ * @details Se acumulan los digitos enteros y decimales en un entero y se divide una unica vez por la potencia de 10
+ * correspondiente, lo que da el mismo float que atof para puntajes con hasta 9 digitos. El campo "\\N" vale 0.
+ *
+ * @param field Campo a convertir.
+ * @param out Valor obtenido.
+ * @return 1 si el campo es un decimal valido o "\\N", 0 si contenia otros caracteres.
+ */
+int parseRating(const TSlice field, float * out);
+
+#endif //TPEFINAL_ROWPARSER_H
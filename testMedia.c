@@ -0,0 +1,199 @@
+#include "mediaADT.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @file testMedia.c
+ * @brief Pruebas del mediaADT.
+ *
+ * @details Verifica que las versiones publicadas con publishMediaADT() no cambien al corregir o añadir contenido
+ * luego de publicarlas: se fija una version, se aplica un delta con updateContent() y addRawContent() y se comparan
+ * las consultas de la version fijada con las del estado anterior al delta. Verifica tambien que addContentBatch()
+ * obtenga lo mismo que addRawContent() fila por fila. Informa cada verificacion que falla y termina con un codigo
+ * distinto de 0 si alguna fallo.
+ *
+ * Uso: testMedia
+ */
+
+#define TEST_YEAR 2000        /**< @def Año de todas las peliculas de la prueba                               */
+#define TEST_ROWS 600         /**< @def Peliculas añadidas antes de publicar (mas de un bloque de contenidos) */
+#define BASE_VOTES 10         /**< @def Votos de la primera pelicula: la pelicula i tiene BASE_VOTES + i     */
+#define BATCH_ROWS 2000       /**< @def Filas del lote que se compara con addRawContent()                      */
+
+/** @def Verifica una condicion e informa la linea si no se cumple */
+#define CHECK(COND) do { if (!(COND)){ fprintf(stderr, "%s:%d: fallo %s\n", __FILE__, __LINE__, #COND); \
+                                      failed++; } } while (0)
+
+static int failed = 0;        /**< Cantidad de verificaciones que fallaron */
+
+/**
+ * @brief Funcion auxiliar que añade o corrige la pelicula "T<number>" del año de la prueba con un unico genero.
+ *
+ * @param media ADT creado para el manejo de peliculas/series.
+ * @param number Numero de la pelicula.
+ * @param votes Cantidad de votos.
+ * @param genre Genero de la pelicula.
+ * @param update 1 para corregirla con updateContent(), 0 para añadirla con addRawContent().
+ * @return Resultado de la funcion del TAD.
+ */
+static int putMovie(mediaADT media, const size_t number, const unsigned long votes, const char * genre,
+                    const int update){
+    char title[MAX_TITLE_SIZE];
+    TRawContent content = {{0}};
+    content.primaryTitle.str = title;
+    content.primaryTitle.len = (size_t)snprintf(title, sizeof(title), "T%zu", number);
+    content.genres[0].str = genre;
+    content.genres[0].len = strlen(genre);
+    content.genresCount = 1;
+    content.startYear = TEST_YEAR;
+    content.runtimeMinutes = 90;
+    content.numVotes = votes;
+    content.averageRating = 5.0f;
+    content.type = CONTENTTYPE_MOVIE;
+    return update ? updateContent(media, &content) : addRawContent(media, &content);
+}
+
+/**
+ * @brief Funcion auxiliar que verifica las consultas de una version publicada con las peliculas T0..T<TEST_ROWS - 1>
+ * del genero "Drama", con sus votos originales.
+ */
+static void checkPublished(const mediaADT version){
+    TContent best = mostVoted(version, TEST_YEAR, CONTENTTYPE_MOVIE);
+    CHECK(strcmp(best.primaryTitle, "T599") == 0);
+    CHECK(best.numVotes == BASE_VOTES + TEST_ROWS - 1);
+    CHECK(countContentByYear(version, TEST_YEAR, CONTENTTYPE_MOVIE) == TEST_ROWS);
+    CHECK(countContentByGenre(version, TEST_YEAR, "Drama", CONTENTTYPE_MOVIE) == TEST_ROWS);
+    CHECK(countContentByGenre(version, TEST_YEAR, "Comedy", CONTENTTYPE_MOVIE) == 0);
+
+    /// La suma recorre los bloques de indices del genero y lee la columna de votos de cada pelicula.
+    TAggregate votes;
+    CHECK(aggregateContent(version, TEST_YEAR, "Drama", CONTENTTYPE_MOVIE, FIELD_NUMVOTES, &votes) == 1);
+    CHECK(votes.count == TEST_ROWS);
+    CHECK(votes.sum == (double)TEST_ROWS * (2 * BASE_VOTES + TEST_ROWS - 1) / 2);
+    CHECK(votes.max == BASE_VOTES + TEST_ROWS - 1);
+
+    TTopCursor cursor;
+    CHECK(toBeginTopCursor(version, &cursor, TEST_YEAR, "Drama", CONTENTTYPE_MOVIE) == 1);
+    CHECK(hasNextTopCursor(&cursor));
+    TContent top = nextTopCursor(version, &cursor);
+    CHECK(strcmp(top.primaryTitle, "T599") == 0);
+    CHECK(top.numVotes == BASE_VOTES + TEST_ROWS - 1);
+}
+
+/**
+ * @brief Prueba que una version fijada no cambie al aplicar un delta al TAD que la publico.
+ */
+static void testPinnedDelta(void){
+    mediaADT media = newMediaADT(0, NULL, MEDIA_FULL);
+    CHECK(media != NULL);
+    if (media == NULL)
+        return;
+    for (size_t i = 0; i < TEST_ROWS; i++)
+        CHECK(putMovie(media, i, BASE_VOTES + i, "Drama", 0) == 1);
+    CHECK(publishMediaADT(media) == 1);
+    TMediaPin pin;
+    CHECK(pinMediaADT(media, &pin) == 1);
+    checkPublished(pin.version);
+
+    /// T599 pierde votos y cambia de genero; T0 (en el bloque de indices mas antiguo) gana votos; T600 es nueva.
+    CHECK(putMovie(media, TEST_ROWS - 1, 1, "Comedy", 1) == 1);
+    CHECK(putMovie(media, 0, 5000, "Drama", 1) == 1);
+    CHECK(putMovie(media, TEST_ROWS, 10000, "Drama", 0) == 1);
+    checkPublished(pin.version);
+
+    TContent best = mostVoted(media, TEST_YEAR, CONTENTTYPE_MOVIE);
+    CHECK(strcmp(best.primaryTitle, "T600") == 0);
+    CHECK(countContentByGenre(media, TEST_YEAR, "Drama", CONTENTTYPE_MOVIE) == TEST_ROWS);
+    CHECK(countContentByGenre(media, TEST_YEAR, "Comedy", CONTENTTYPE_MOVIE) == 1);
+    TAggregate votes;
+    CHECK(aggregateContent(media, TEST_YEAR, "Drama", CONTENTTYPE_MOVIE, FIELD_NUMVOTES, &votes) == 1);
+    CHECK(votes.sum == (double)TEST_ROWS * (2 * BASE_VOTES + TEST_ROWS - 1) / 2 - (BASE_VOTES + TEST_ROWS - 1)
+                       - BASE_VOTES + 5000 + 10000);
+
+    /// Una nueva publicacion muestra el delta y la version fijada antes sigue sin cambios al corregir otra vez.
+    CHECK(publishMediaADT(media) == 1);
+    TMediaPin next;
+    CHECK(pinMediaADT(media, &next) == 1);
+    CHECK(putMovie(media, TEST_ROWS, 2, "Comedy", 1) == 1);
+    best = mostVoted(next.version, TEST_YEAR, CONTENTTYPE_MOVIE);
+    CHECK(strcmp(best.primaryTitle, "T600") == 0);
+    CHECK(best.numVotes == 10000);
+    CHECK(countContentByGenre(next.version, TEST_YEAR, "Comedy", CONTENTTYPE_MOVIE) == 1);
+    checkPublished(pin.version);
+
+    unpinMediaADT(media, &next);
+    unpinMediaADT(media, &pin);
+    freeMediaADT(media);
+}
+
+/**
+ * @brief Prueba que addContentBatch() obtenga lo mismo que addRawContent() con las mismas filas en orden: años
+ * desordenados, generos escritos de distintas formas (y "\\N") y filas invalidas.
+ */
+static void testBatchMatchesRows(void){
+    static TRawContent rows[BATCH_ROWS];
+    static char titles[BATCH_ROWS][16];
+    static int status[BATCH_ROWS];
+    const char * genres[] = {"Drama", "drama", "Comedy", "\\N", "Action", "COMEDY"};
+    const size_t genresCount = sizeof(genres) / sizeof(genres[0]);
+    for (size_t i = 0; i < BATCH_ROWS; i++){
+        TRawContent * row = &rows[i];
+        memset(row, 0, sizeof(*row));
+        row->primaryTitle.str = titles[i];
+        row->primaryTitle.len = (size_t)snprintf(titles[i], sizeof(titles[i]), "B%zu", i);
+        row->genresCount = 1 + i % 3;
+        for (size_t j = 0; j < row->genresCount; j++){
+            row->genres[j].str = genres[(i * 7 + j * 5) % genresCount];
+            row->genres[j].len = strlen(row->genres[j].str);
+        }
+        /// Los años se recorren salteados, e incluyen años menores al minimo del TAD.
+        row->startYear = (unsigned short)(1890 + (i * 37) % 130);
+        row->runtimeMinutes = (unsigned short)(60 + i % 90);
+        row->numVotes = (i * 7919) % 100003;
+        row->averageRating = (float)(i % 100) / 10;
+        row->type = i % 101 == 0 ? 0 : (i % 4 == 0 ? CONTENTTYPE_SERIES : CONTENTTYPE_MOVIE);
+    }
+
+    mediaADT single = newMediaADT(1900, NULL, MEDIA_FULL);
+    mediaADT batch = newMediaADT(1900, NULL, MEDIA_FULL);
+    CHECK(single != NULL && batch != NULL);
+    if (single == NULL || batch == NULL){
+        if (single != NULL)
+            freeMediaADT(single);
+        if (batch != NULL)
+            freeMediaADT(batch);
+        return;
+    }
+    CHECK(addContentBatch(batch, rows, BATCH_ROWS, status) == 1);
+    for (size_t i = 0; i < BATCH_ROWS; i++)
+        CHECK(addRawContent(single, &rows[i]) == status[i]);
+
+    for (unsigned short year = 1890; year < 2020; year++)
+        for (contentType type = CONTENTTYPE_MOVIE; type <= CONTENTTYPE_SERIES; type++){
+            CHECK(countContentByYear(single, year, type) == countContentByYear(batch, year, type));
+            for (size_t j = 0; j < genresCount; j++)
+                CHECK(countContentByGenre(single, year, genres[j], type) ==
+                      countContentByGenre(batch, year, genres[j], type));
+            TContent a = mostVoted(single, year, type), b = mostVoted(batch, year, type);
+            CHECK(strcmp(a.primaryTitle, b.primaryTitle) == 0 && a.numVotes == b.numVotes);
+            TAggregate sumA, sumB;
+            CHECK(aggregateContent(single, year, "Drama", type, FIELD_NUMVOTES, &sumA) == 1);
+            CHECK(aggregateContent(batch, year, "Drama", type, FIELD_NUMVOTES, &sumB) == 1);
+            CHECK(sumA.count == sumB.count && sumA.sum == sumB.sum);
+        }
+    CHECK(countContentByYearRange(single, 1900, 2020, CONTENTTYPE_MOVIE) ==
+          countContentByYearRange(batch, 1900, 2020, CONTENTTYPE_MOVIE));
+    freeMediaADT(single);
+    freeMediaADT(batch);
+}
+
+int main(void){
+    testPinnedDelta();
+    testBatchMatchesRows();
+    if (failed > 0){
+        fprintf(stderr, "%d verificaciones fallaron\n", failed);
+        return 1;
+    }
+    puts("OK");
+    return 0;
+}